@@ -0,0 +1,384 @@
+// Micro and end-to-end benchmarks for the pipeline hot paths. Prints a table
+// and writes machine-readable JSON (--output) so runs can be compared.
+//
+// Usage: ecoperceptron_bench [--rows N] [--plots P] [--steps S] [--epochs E]
+//                            [--repetitions R] [--filter substring] [--output file.json]
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include <nlohmann/json.hpp>
+#include "data_loader.h"
+#include "domain.h"
+#include "perceptron.h"
+#include "perceptron_kernels.h"
+#include "result_sink.h"
+#include "services.h"
+#include "fleet.h"
+#include "inference_server.h"
+#include "synthetic_data.h"
+
+using json = nlohmann::json;
+
+namespace {
+
+struct BenchConfig {
+    size_t rows = 200000;   // Experiment / trajectory rows
+    size_t plots = 200;     // Fleet plots
+    size_t steps = 500;     // Steps per fleet plot
+    int epochs = 5;         // Training epochs per measured run
+    int repetitions = 5;
+    std::string filter;
+    std::string outputPath;
+};
+
+struct BenchResult {
+    std::string name;
+    size_t items;         // Work units per run (rows, steps, calls)
+    int repetitions;
+    double minSeconds;
+    double medianSeconds;
+    double itemsPerSecond; // From the median
+};
+
+// Sends std::cout (loader and service logs) to nowhere while measuring
+class QuietCout {
+public:
+    QuietCout() : previous_(std::cout.rdbuf(nullptr)) {}
+    ~QuietCout() { std::cout.rdbuf(previous_); }
+private:
+    std::streambuf* previous_;
+};
+
+// Daemon replies reduced to a checksum, so server.batcher measures no transport
+class SummingReplyChannel : public InferenceReplyChannel {
+public:
+    void reply(std::string_view, size_t, const InferenceOutput& output) override { sum += output.functionalIntegrity; }
+    void replyJson(const std::string&) override {}
+    float sum = 0.0f;
+};
+
+// Keeps the optimizer from discarding benchmarked results
+volatile float sink_;
+
+class BenchRunner {
+public:
+    explicit BenchRunner(const BenchConfig& config) : config_(config) {}
+
+    // Runs 'fn' once to warm up, then 'repetitions' measured times
+    template <typename Fn>
+    void run(const std::string& name, size_t items, Fn&& fn) {
+        if (!config_.filter.empty() && name.find(config_.filter) == std::string::npos) return;
+
+        std::vector<double> seconds;
+        {
+            QuietCout quiet;
+            fn();
+            for (int r = 0; r < config_.repetitions; ++r) {
+                const auto start = std::chrono::steady_clock::now();
+                fn();
+                seconds.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            }
+        }
+        std::sort(seconds.begin(), seconds.end());
+
+        BenchResult result{name, items, config_.repetitions, seconds.front(), seconds[seconds.size() / 2], 0.0};
+        result.itemsPerSecond = result.medianSeconds > 0.0 ? items / result.medianSeconds : 0.0;
+        std::printf("%-32s %12zu items  median %10.3f ms  min %10.3f ms  %12.0f items/s\n",
+                    name.c_str(), items, result.medianSeconds * 1e3, result.minSeconds * 1e3,
+                    result.itemsPerSecond);
+        results_.push_back(result);
+    }
+
+    const std::vector<BenchResult>& results() const { return results_; }
+
+private:
+    const BenchConfig& config_;
+    std::vector<BenchResult> results_;
+};
+
+// One synthetic plot; fixed seed so every run measures the same data
+std::vector<EcofunctionalSample> syntheticSamples(size_t count, uint64_t seed) {
+    SyntheticPlotGenerator generator(seed, 0);
+    std::vector<EcofunctionalSample> samples(count);
+    for (auto& sample : samples) sample = generator.next();
+    return samples;
+}
+
+void writeCsv(const std::string& path, const std::vector<EcofunctionalSample>& samples,
+              bool withTarget, size_t plots = 0) {
+    std::ofstream out(path);
+    if (plots > 0) out << "PlotId,";
+    out << "SoilDepth,SoilComp,SoilInfilt,HydroFlux,ErosionRisk,VegCovEI,VegCovES,VegVigorEI,VegVigorES,PropPot";
+    out << (withTarget ? ",FunctionalIntegrity\n" : "\n");
+
+    const size_t perPlot = plots > 0 ? (samples.size() + plots - 1) / plots : 0;
+    for (size_t i = 0; i < samples.size(); ++i) {
+        if (plots > 0) out << "PLOT-" << i / perPlot << ',';
+        const auto values = samples[i].inputVector.toArray();
+        for (size_t c = 0; c < values.size(); ++c)
+            out << (c ? "," : "") << values[c];
+        if (withTarget) out << ',' << samples[i].targetLabel;
+        out << '\n';
+    }
+}
+
+void runBenchmarks(const BenchConfig& config, BenchRunner& bench, const std::filesystem::path& workDir) {
+    const auto samples = syntheticSamples(config.rows, 42);
+
+    EcofunctionalExperiment experiment("BENCH");
+    for (const auto& sample : samples) experiment.addSample(sample);
+    EcofunctionalTrajectory trajectory;
+    for (const auto& sample : samples) trajectory.addSample(sample);
+
+    const std::vector<FeatureVector> X = buildFeatureMatrix(experiment.getSamples());
+    const float* labels = experiment.getSamples().labels().data;
+    const size_t n = X.size();
+
+    Perceptron model;
+    PerceptronTrainingService trainer;
+    {
+        QuietCout quiet;
+        trainer.trainFullExperiment(model, experiment, 0.1f, 1);
+    }
+    PerceptronInferenceService inference;
+
+    // ---- Perceptron ----
+    bench.run("perceptron.infer", n, [&] {
+        float acc = 0.0f;
+        for (size_t i = 0; i < n; ++i) acc += model.infer(X[i]);
+        sink_ = acc;
+    });
+    std::vector<float> scores(n);
+    bench.run(std::string("perceptron.inferBatch.") + kernels::isaName(kernels::activeIsa()), n, [&] {
+        model.inferBatch(X.data(), n, scores.data());
+        sink_ = scores[n / 2];
+    });
+    bench.run("perceptron.train.sgd", n * config.epochs, [&] {
+        Perceptron m;
+        TrainingOptions options;
+        options.epochs = config.epochs;
+        m.train(X.data(), labels, n, options);
+        sink_ = m.bias();
+    });
+    bench.run("perceptron.train.minibatch64", n * config.epochs, [&] {
+        Perceptron m;
+        TrainingOptions options;
+        options.epochs = config.epochs;
+        options.batchSize = 64;
+        m.train(X.data(), labels, n, options);
+        sink_ = m.bias();
+    });
+
+    // ---- Feature engineering and state analysis ----
+    bench.run("features.buildFeatureMatrix", n, [&] {
+        auto matrix = buildFeatureMatrix(experiment.getSamples());
+        sink_ = matrix.back()[0];
+    });
+    bench.run("features.streamingState", n, [&] {
+        // EcofunctionalFeatureState::push and featureRow per step, as inference reads them
+        TrajectoryCursor cursor(trajectory);
+        float acc = 0.0f;
+        while (cursor.next()) acc += cursor.featureState().featureRow()[2 * ECOVECTOR_SIZE];
+        sink_ = acc;
+    });
+    bench.run("trajectory.classifyState", n, [&] {
+        TrajectoryCursor cursor(trajectory);
+        int acc = 0;
+        while (cursor.next())
+            acc += static_cast<int>(EcofunctionalTrajectory::classifyState(cursor.featureState()));
+        sink_ = static_cast<float>(acc);
+    });
+    {
+        // Classification and interpretation alone, over the trends and scores of every step
+        std::vector<float> trends;
+        std::vector<size_t> stepCounts;
+        TrajectoryCursor cursor(trajectory);
+        while (cursor.next()) {
+            trends.push_back(cursor.featureState().vegetationTrend);
+            stepCounts.push_back(cursor.featureState().steps);
+        }
+        std::vector<EcofunctionalTrajectory::TrajectoryState> states(n);
+        std::vector<InferenceOutput> interpreted(n);
+        bench.run("trajectory.interpret.scalar", n, [&] {
+            EcofunctionalFeatureState state;
+            for (size_t i = 0; i < n; ++i) {
+                state.vegetationTrend = trends[i];
+                state.steps = stepCounts[i];
+                interpreted[i] = PerceptronInferenceService::interpretScore(
+                    scores[i], EcofunctionalTrajectory::classifyState(state), trends[i]);
+            }
+            sink_ = interpreted[n / 2].recoveryCapacity;
+        });
+        bench.run("trajectory.interpret.batch", n, [&] {
+            EcofunctionalTrajectory::classifyStates(trends.data(), stepCounts.data(), n, states.data());
+            PerceptronInferenceService::interpretScores(scores.data(), states.data(), trends.data(), n,
+                                                        interpreted.data());
+            sink_ = interpreted[n / 2].recoveryCapacity;
+        });
+    }
+    bench.run("inference.replay", n, [&] {
+        auto outputs = inference.replay(model, trajectory);
+        sink_ = outputs.back().recoveryCapacity;
+    });
+    bench.run("inference.boundedStream", n, [&] {
+        // Monitoring loop: samples arrive one by one into a constant-memory trajectory
+        auto live = EcofunctionalTrajectory::bounded();
+        float acc = 0.0f;
+        for (const auto& sample : samples) {
+            live.addSample(sample);
+            acc += inference.inferState(model, live).functionalIntegrity;
+        }
+        sink_ = acc;
+    });
+    bench.run("server.batcher", n, [&] {
+        // Daemon path without the transport: per-plot streams scored in micro-batches
+        InferenceBatcher batcher(model);
+        auto channel = std::make_shared<SummingReplyChannel>();
+        const std::string plotIds[] = {"PLOT-A", "PLOT-B", "PLOT-C", "PLOT-D"};
+        for (size_t i = 0; i < n; ++i)
+            batcher.submit(plotIds[i % 4], samples[i].inputVector, channel);
+        batcher.drain();
+        sink_ = channel->sum;
+    });
+
+    // ---- Loaders ----
+    const std::string experimentCsv = (workDir / "experiment.csv").string();
+    const std::string trajectoryCsv = (workDir / "trajectory.csv").string();
+    const std::string fleetCsv = (workDir / "fleet.csv").string();
+    const auto fleetSamples = syntheticSamples(config.plots * config.steps, 7);
+    writeCsv(experimentCsv, samples, true);
+    writeCsv(trajectoryCsv, samples, false);
+    writeCsv(fleetCsv, fleetSamples, false, config.plots);
+
+    bench.run("loader.experimentCSV", n, [&] {
+        auto e = DataLoader::loadExperimentFromCSV(experimentCsv, "BENCH");
+        sink_ = static_cast<float>(e.getSamples().size());
+    });
+    bench.run("loader.trajectoryCSV", n, [&] {
+        auto t = DataLoader::loadTrajectoryFromCSV(trajectoryCsv);
+        sink_ = static_cast<float>(t.history.size());
+    });
+    bench.run("loader.fleetCSV", fleetSamples.size(), [&] {
+        auto f = DataLoader::loadFleetFromCSV(fleetCsv);
+        sink_ = static_cast<float>(f.size());
+    });
+
+    // ---- Result output (replaces the former saveInferenceLog) ----
+    std::vector<InferenceOutput> outputs;
+    {
+        QuietCout quiet;
+        outputs = inference.replay(model, trajectory);
+    }
+    for (const char* name : {"results.ndjson", "results.ecores"}) {
+        const std::string path = (workDir / name).string();
+        bench.run(std::string("sink.") + name, outputs.size(), [&] {
+            auto resultSink = openResultSink(path);
+            resultSink->write("", 0, outputs.data(), outputs.size());
+            resultSink->close();
+        });
+    }
+
+    // ---- End to end ----
+    std::vector<PlotTrajectory> plots;
+    {
+        QuietCout quiet;
+        plots = DataLoader::loadFleetFromCSV(fleetCsv);
+    }
+    bench.run("e2e.trainAndReplay", n, [&] {
+        Perceptron m;
+        trainer.trainFullExperiment(m, experiment, 0.1f, config.epochs);
+        auto result = inference.replay(m, trajectory);
+        sink_ = result.back().functionalIntegrity;
+    });
+    FleetInferenceEngine engine;
+    const std::string fleetResults = (workDir / "fleet_results.ecores").string();
+    bench.run("e2e.fleetToSink", fleetSamples.size(), [&] {
+        auto resultSink = openResultSink(fleetResults);
+        auto summaries = engine.run(model, plots, *resultSink);
+        resultSink->close();
+        sink_ = static_cast<float>(summaries.size());
+    });
+}
+
+json toJson(const BenchConfig& config, const std::vector<BenchResult>& results) {
+    json j;
+    j["schema_version"] = 1;
+    j["kernel_isa"] = kernels::isaName(kernels::activeIsa());
+    j["hardware_threads"] = std::thread::hardware_concurrency();
+    j["config"] = {
+        {"rows", config.rows}, {"plots", config.plots}, {"steps", config.steps},
+        {"epochs", config.epochs}, {"repetitions", config.repetitions}
+    };
+    std::vector<json> entries;
+    for (const auto& r : results) {
+        entries.push_back({
+            {"name", r.name},
+            {"items", r.items},
+            {"repetitions", r.repetitions},
+            {"min_seconds", r.minSeconds},
+            {"median_seconds", r.medianSeconds},
+            {"items_per_second", r.itemsPerSecond}
+        });
+    }
+    j["results"] = entries;
+    return j;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchConfig config;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (i + 1 >= argc) throw std::invalid_argument("Missing value for argument: " + arg);
+            if (arg == "--rows") config.rows = std::stoul(argv[++i]);
+            else if (arg == "--plots") config.plots = std::stoul(argv[++i]);
+            else if (arg == "--steps") config.steps = std::stoul(argv[++i]);
+            else if (arg == "--epochs") config.epochs = std::stoi(argv[++i]);
+            else if (arg == "--repetitions") config.repetitions = std::stoi(argv[++i]);
+            else if (arg == "--filter") config.filter = argv[++i];
+            else if (arg == "--output") config.outputPath = argv[++i];
+            else throw std::invalid_argument("Unknown argument: " + arg);
+        }
+        if (config.rows < 2 || config.plots == 0 || config.steps == 0 ||
+            config.epochs < 1 || config.repetitions < 1) {
+            throw std::invalid_argument("Sizes, epochs and repetitions must be positive (rows >= 2)");
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\nUsage: ecoperceptron_bench [--rows N] [--plots P] [--steps S] [--epochs E]"
+                  << " [--repetitions R] [--filter substring] [--output file.json]" << std::endl;
+        return 1;
+    }
+
+    const auto workDir = std::filesystem::temp_directory_path() /
+                         ("ecoperceptron_bench_" + std::to_string(::getpid()));
+    std::filesystem::create_directories(workDir);
+
+    BenchRunner bench(config);
+    std::printf("[Bench] rows=%zu plots=%zu steps=%zu epochs=%d repetitions=%d isa=%s\n",
+                config.rows, config.plots, config.steps, config.epochs, config.repetitions,
+                kernels::isaName(kernels::activeIsa()));
+    int status = 0;
+    try {
+        runBenchmarks(config, bench, workDir);
+    } catch (const std::exception& e) {
+        std::cerr << "[Bench] " << e.what() << std::endl;
+        status = 1;
+    }
+    std::filesystem::remove_all(workDir);
+
+    if (status == 0 && !config.outputPath.empty()) {
+        std::ofstream out(config.outputPath);
+        out << toJson(config, bench.results()).dump(2) << std::endl;
+        std::printf("[Bench] Results written to %s\n", config.outputPath.c_str());
+    }
+    return status;
+}
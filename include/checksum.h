@@ -0,0 +1,15 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+constexpr uint64_t FNV1A_OFFSET_BASIS = 14695981039346656037ULL;
+
+// FNV-1a over raw bytes; chain calls by passing the previous result as 'hash'
+inline uint64_t fnv1a(uint64_t hash, const void* data, size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
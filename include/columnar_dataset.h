@@ -0,0 +1,138 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "feature_vector.h"
+#include "mapped_file.h"
+
+// ==========================================
+// Binary columnar dataset format (.ecol)
+// ==========================================
+// Layout: a fixed ColumnarHeader followed by column blocks, each starting on
+// a COLUMNAR_ALIGNMENT boundary:
+//   - ECOVECTOR_SIZE float32 attribute columns (EcofunctionalVector order)
+//   - optional float32 target column
+//   - optional uint32 plot index column (into the plot id table)
+//   - optional int64 timestamp column
+//   - optional plot id table: per plot a uint32 length followed by its bytes
+// Values are stored in host byte order (little-endian on supported targets).
+// The file is memory-mapped and the columns are used in place.
+
+constexpr char COLUMNAR_MAGIC[8] = {'E', 'C', 'O', 'C', 'O', 'L', 'S', '\0'};
+constexpr uint32_t COLUMNAR_VERSION = 1;
+constexpr size_t COLUMNAR_ALIGNMENT = 64;
+
+enum ColumnarFlags : uint32_t {
+    COLUMNAR_HAS_TARGET = 1u << 0,
+    COLUMNAR_HAS_PLOT_ID = 1u << 1,
+    COLUMNAR_HAS_TIMESTAMP = 1u << 2
+};
+
+struct ColumnarHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t rowCount;
+    uint32_t attributeCount;
+    uint32_t plotCount;
+    uint64_t attributeOffsets[ECOVECTOR_SIZE];
+    uint64_t targetOffset;
+    uint64_t plotIndexOffset;
+    uint64_t timestampOffset;
+    uint64_t plotTableOffset;
+    uint64_t plotTableSize;
+    uint8_t reserved[40];
+};
+static_assert(sizeof(ColumnarHeader) % COLUMNAR_ALIGNMENT == 0, "Header must keep columns aligned");
+
+// In-memory columns, used to write a file
+struct ColumnarTable {
+    std::array<std::vector<float>, ECOVECTOR_SIZE> attributes;
+    std::vector<float> target;        // empty when absent
+    std::vector<uint32_t> plotIndex;  // empty when absent
+    std::vector<std::string> plotIds; // table referenced by plotIndex
+    std::vector<int64_t> timestamps;  // empty when absent
+
+    size_t rowCount() const { return attributes[0].size(); }
+};
+
+void writeColumnarFile(const std::string& path, const ColumnarTable& table);
+
+constexpr size_t COLUMNAR_STREAM_CHUNK_ROWS = 64 * 1024;
+
+// Writes a .ecol file whose row count is known up front without holding the
+// table in memory: rows are buffered COLUMNAR_STREAM_CHUNK_ROWS at a time and
+// each column's chunk is written in place at its block offset. The file is
+// byte-identical to writeColumnarFile with the same columns.
+class ColumnarStreamWriter {
+public:
+    // 'flags' selects the optional columns (COLUMNAR_HAS_*); throws std::runtime_error
+    // if the file cannot be created
+    ColumnarStreamWriter(const std::string& path, uint64_t rowCount, uint32_t flags,
+                         std::vector<std::string> plotIds = {});
+    ~ColumnarStreamWriter();
+
+    ColumnarStreamWriter(const ColumnarStreamWriter&) = delete;
+    ColumnarStreamWriter& operator=(const ColumnarStreamWriter&) = delete;
+
+    // Values of columns absent from 'flags' are ignored
+    void append(const std::array<float, ECOVECTOR_SIZE>& attributes, float target = 0.0f,
+                uint32_t plotIndex = 0, int64_t timestamp = 0);
+    // Writes the plot table; throws std::runtime_error unless exactly rowCount rows were appended
+    void close();
+
+private:
+    template <typename T>
+    void writeChunk(uint64_t columnOffset, std::vector<T>& values);
+    void flushChunk();
+
+    ColumnarHeader header_;
+    std::vector<std::string> plotIds_;
+    std::ofstream out_;
+    std::string path_;
+    uint64_t written_ = 0; // Rows already in the file
+    bool closed_ = false;
+
+    // Current chunk, one buffer per column
+    std::array<std::vector<float>, ECOVECTOR_SIZE> attributes_;
+    std::vector<float> target_;
+    std::vector<uint32_t> plotIndex_;
+    std::vector<int64_t> timestamps_;
+};
+
+// Reads a header-described CSV into columns. Columns named "PlotId" and
+// "Timestamp" are recognised anywhere in the header; the remaining numeric
+// columns are the 10 attributes followed by an optional target.
+ColumnarTable columnarTableFromCSV(const std::string& csvPath);
+
+// Read-only, zero-copy view of a memory-mapped .ecol file
+class ColumnarDataset {
+public:
+    // Throws std::runtime_error if the file cannot be opened or is malformed
+    void open(const std::string& path);
+
+    size_t rowCount() const { return header_->rowCount; }
+    bool hasTarget() const { return header_->flags & COLUMNAR_HAS_TARGET; }
+    bool hasPlotId() const { return header_->flags & COLUMNAR_HAS_PLOT_ID; }
+    bool hasTimestamp() const { return header_->flags & COLUMNAR_HAS_TIMESTAMP; }
+
+    const float* attribute(size_t index) const;
+    const float* target() const;          // nullptr when absent
+    const uint32_t* plotIndex() const;    // nullptr when absent
+    const int64_t* timestamps() const;    // nullptr when absent
+    const std::vector<std::string>& plotIds() const { return plotIds_; }
+
+private:
+    template <typename T>
+    const T* column(uint64_t offset) const;
+
+    MappedFile file_;
+    const ColumnarHeader* header_ = nullptr;
+    std::vector<std::string> plotIds_;
+};
+
+// True if 'path' names a .ecol file (by extension)
+bool isColumnarPath(const std::string& path);
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "mapped_file.h"
+
+// ==========================================
+// Zero-copy CSV ingestion primitives
+// ==========================================
+
+// Splits a buffer into lines in place. Matches std::getline: '\n' separated,
+// a final line without newline is returned, a trailing '\r' is stripped.
+class CsvLineReader {
+public:
+    explicit CsvLineReader(std::string_view buffer, size_t firstLineNumber = 1);
+
+    bool next(std::string_view& line);
+    size_t lineNumber() const { return lineNumber_; } // Line number of the last line returned
+    size_t offset() const { return pos_ < buffer_.size() ? pos_ : buffer_.size(); } // Start of the next line
+
+private:
+    std::string_view buffer_;
+    size_t pos_ = 0;
+    size_t lineNumber_;
+};
+
+// Splits one line into comma-separated fields in place. Like std::getline on
+// a stringstream, a trailing comma does not produce an extra empty field.
+class CsvFieldReader {
+public:
+    explicit CsvFieldReader(std::string_view line) : line_(line) {}
+
+    bool next(std::string_view& field);
+
+private:
+    std::string_view line_;
+    size_t pos_ = 0;
+};
+
+// Locale-independent, non-allocating float parser (std::from_chars). Leading
+// whitespace and '+' are accepted and, like std::stof, a numeric prefix is
+// enough; empty, non-numeric and out-of-range fields are rejected.
+bool parseFloat(std::string_view field, float& out);
+
+// Validation message tied to a 1-based file line number
+struct CsvDiagnostic {
+    size_t line;
+    std::string message;
+};
+
+// Parses the remaining fields of 'fields' as floats. The first 'capacity'
+// valid values are stored in 'out'; the number of valid values is returned.
+// Invalid fields are recorded in 'diagnostics' against 'lineNumber'.
+size_t parseFloatFields(CsvFieldReader& fields, float* out, size_t capacity,
+                        std::vector<CsvDiagnostic>& diagnostics, size_t lineNumber);
+
+// Prints diagnostics on std::cerr as "<tag> <message> (line N)"
+void reportDiagnostics(const std::vector<CsvDiagnostic>& diagnostics, const char* tag);
+
+// Splits 'buffer' into at most 'maxChunks' newline-aligned ranges of at
+// least 'minChunkBytes' each (the last one may be shorter). Concatenating
+// the chunks gives back the buffer, and no line straddles two chunks.
+std::vector<std::string_view> splitCsvChunks(std::string_view buffer, size_t maxChunks,
+                                             size_t minChunkBytes = 1 << 20);
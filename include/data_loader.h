@@ -4,12 +4,33 @@
 #include "domain.h"
 #include "dataset.h" // Reusing low-level CSV util
 
+// Every loader accepts a thread count: large files are split into
+// newline-aligned chunks parsed in parallel and merged in file order
+// (1 = single-threaded, 0 = all hardware threads). Diagnostics report file
+// line numbers either way.
 class DataLoader {
 public:
     // Loads a CSV where each row is a time-step.
     // Expected Format: ID, SoilDepth, HydroFlux, ... (10 features), Target(Optional)
-    static EcofunctionalExperiment loadExperimentFromCSV(const std::string& filepath, const std::string& experimentId);
+    static EcofunctionalExperiment loadExperimentFromCSV(const std::string& filepath, const std::string& experimentId,
+                                                         size_t threads = 1);
 
     // Loads a specific single trajectory (e.g. for inference)
-    static EcofunctionalTrajectory loadTrajectoryFromCSV(const std::string& filepath);
+    static EcofunctionalTrajectory loadTrajectoryFromCSV(const std::string& filepath, size_t threads = 1);
+
+    // Loads many plots from one CSV grouped by its first column.
+    // Expected Format: PlotId, SoilDepth, HydroFlux, ... (10 features)
+    // Rows of a plot keep their file order; plots are returned in order of first appearance.
+    static std::vector<PlotTrajectory> loadFleetFromCSV(const std::string& filepath, size_t threads = 1);
+
+    // Same data read from a memory-mapped binary columnar file (.ecol), no parsing
+    static EcofunctionalExperiment loadExperimentFromColumnar(const std::string& filepath, const std::string& experimentId);
+    static EcofunctionalTrajectory loadTrajectoryFromColumnar(const std::string& filepath);
+    static std::vector<PlotTrajectory> loadFleetFromColumnar(const std::string& filepath);
+
+    // Pick the columnar or CSV loader from the file extension
+    static EcofunctionalExperiment loadExperiment(const std::string& filepath, const std::string& experimentId,
+                                                  size_t threads = 1);
+    static EcofunctionalTrajectory loadTrajectory(const std::string& filepath, size_t threads = 1);
+    static std::vector<PlotTrajectory> loadFleet(const std::string& filepath, size_t threads = 1);
 };
@@ -2,6 +2,11 @@
 #include <vector>
 #include <string>
 #include <iostream>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <algorithm>
+#include "feature_vector.h"
 
 // ==========================================
 // Value Objects
@@ -20,7 +25,9 @@ struct EcofunctionalVector {
     float propagulePotential;
 
     std::vector<float> toVector() const;
+    std::array<float, ECOVECTOR_SIZE> toArray() const;
     static EcofunctionalVector fromVector(const std::vector<float>& vec);
+    static EcofunctionalVector fromArray(const std::array<float, ECOVECTOR_SIZE>& arr);
 
     // Operator overloads for convenient math
     EcofunctionalVector operator-(const EcofunctionalVector& other) const;
@@ -37,10 +44,110 @@ struct EcofunctionalSample {
     float targetLabel; // Simplified target for single-output perceptron (e.g. Integrity)
 };
 
+// Read-only view over one contiguous column of a sample store
+struct ColumnView {
+    const float* data = nullptr;
+    size_t size = 0;
+
+    const float* begin() const { return data; }
+    const float* end() const { return data + size; }
+    float operator[](size_t i) const { return data[i]; }
+};
+
+// Structure-of-arrays sample storage: one contiguous column per attribute
+// (EcofunctionalVector order) plus a label column. Rows are materialised on
+// access, so element access and iteration yield EcofunctionalSample by value.
+//
+// A bounded store keeps only the last 'capacity' samples in a fixed ring;
+// index 0 is the oldest retained sample. Each sample is written twice, at its
+// ring slot and at slot + capacity, so the retained window of every column is
+// still one contiguous range and ColumnView consumers work unchanged.
+class EcofunctionalSampleStore {
+public:
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = EcofunctionalSample;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = EcofunctionalSample;
+
+        const_iterator(const EcofunctionalSampleStore* store, size_t index) : store_(store), index_(index) {}
+
+        EcofunctionalSample operator*() const { return (*store_)[index_]; }
+        const_iterator& operator++() { ++index_; return *this; }
+        bool operator==(const const_iterator& other) const { return index_ == other.index_; }
+        bool operator!=(const const_iterator& other) const { return index_ != other.index_; }
+
+    private:
+        const EcofunctionalSampleStore* store_;
+        size_t index_;
+    };
+
+    EcofunctionalSampleStore() = default;
+    static EcofunctionalSampleStore bounded(size_t capacity);
+
+    void push_back(const EcofunctionalSample& sample);
+    // Appends 'count' rows column by column; 'labels' may be nullptr (labels become 0)
+    void appendColumns(const std::array<const float*, ECOVECTOR_SIZE>& attributes, const float* labels, size_t count);
+    void reserve(size_t count); // No-op for a bounded store
+
+    size_t size() const { return capacity_ ? retained_ : labels_.size(); }
+    bool empty() const { return size() == 0; }
+    bool isBounded() const { return capacity_ > 0; }
+    size_t capacity() const { return capacity_; } // 0 when unbounded
+
+    EcofunctionalSample operator[](size_t index) const;
+    EcofunctionalSample back() const { return (*this)[size() - 1]; }
+    EcofunctionalVector vectorAt(size_t index) const;
+
+    ColumnView attribute(size_t index) const { return {attributes_[index].data() + first_, size()}; }
+    ColumnView labels() const { return {labels_.data() + first_, size()}; }
+
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end() const { return {this, size()}; }
+
+private:
+    std::array<std::vector<float>, ECOVECTOR_SIZE> attributes_;
+    std::vector<float> labels_;
+    // Bounded mode only: columns hold 2 * capacity_ mirrored slots
+    size_t capacity_ = 0;
+    size_t first_ = 0; // physical index of the oldest retained sample
+    size_t retained_ = 0;
+};
+
+// Streaming feature accumulator. Updated once per sample so that the
+// temporal features (the ActiveFeaturePipeline blocks and the trends used by
+// state classification) cost O(1) per step instead of rescanning the history.
+struct EcofunctionalFeatureState {
+    EcofunctionalVector current{};
+    EcofunctionalVector delta{}; // current - previous
+    size_t steps = 0;
+    float vegetationTrend = 0.0f;
+    float hydroTrend = 0.0f;
+    ActiveFeaturePipeline::State pipeline; // Keeps its own window of past samples
+
+    void push(const EcofunctionalVector& sample);
+    // Model input for the samples pushed so far; zero before the first one
+    FeatureVector featureRow() const;
+};
+
+// Samples a bounded trajectory keeps by default: the current one plus the
+// lookback of the feature pipeline, and at least the two the trends compare
+constexpr size_t BOUNDED_HISTORY_CAPACITY = std::max<size_t>(ActiveFeaturePipeline::HISTORY + 1, 2);
+
 struct EcofunctionalTrajectory {
-    std::vector<EcofunctionalSample> history;
+    EcofunctionalSampleStore history;
+    EcofunctionalFeatureState featureState; // Kept in sync by addSample; do not push to history directly
+
+    // Constant-memory trajectory for long-running streams: history keeps only
+    // the last 'capacity' samples while featureState still covers every sample
+    // added. Inference from featureState is unaffected; offline analysis of the
+    // history (replay, feature matrices, calculateAverage) sees only the retained window.
+    static EcofunctionalTrajectory bounded(size_t capacity = BOUNDED_HISTORY_CAPACITY);
 
     void addSample(const EcofunctionalSample& sample);
+    size_t stepsSeen() const { return featureState.steps; } // Samples added, retained or not
     
     // Feature Engineering Methods
     EcofunctionalVector calculateAverage(int windowSize) const;
@@ -58,6 +165,37 @@ struct EcofunctionalTrajectory {
     TrajectoryState analyzeState() const;
     float getVegetationTrend() const;
     float getHydroTrend() const;
+
+    // Classification rules shared by analyzeState and cursor-based replay
+    static TrajectoryState classifyState(const EcofunctionalFeatureState& state);
+    // Same rules for 'count' steps at once (one plot's replay or one step of many
+    // plots): out[i] is classifyState of a state with steps[i] samples and
+    // vegetationTrends[i]. Branch-free, so the loop vectorizes and noisy trends
+    // cost no mispredictions.
+    static void classifyStates(const float* vegetationTrends, const size_t* steps, size_t count,
+                               TrajectoryState* out);
+};
+
+// Walks an existing history one step at a time, keeping the streaming feature
+// state exactly as addSample would, without copying samples into a new trajectory.
+class TrajectoryCursor {
+public:
+    explicit TrajectoryCursor(const EcofunctionalTrajectory& trajectory);
+
+    bool next(); // Advances one step; false once the history is exhausted
+    size_t position() const; // Number of samples consumed so far
+    const EcofunctionalFeatureState& featureState() const;
+
+private:
+    const EcofunctionalSampleStore& history_;
+    size_t position_ = 0;
+    EcofunctionalFeatureState state_;
+};
+
+// One independent landscape plot and its own trajectory
+struct PlotTrajectory {
+    std::string plotId;
+    EcofunctionalTrajectory trajectory;
 };
 
 struct InferenceOutput {
@@ -75,10 +213,11 @@ public:
     EcofunctionalExperiment(const std::string& id);
 
     void addSample(const EcofunctionalSample& sample);
-    const std::vector<EcofunctionalSample>& getSamples() const;
+    const EcofunctionalSampleStore& getSamples() const;
+    EcofunctionalSampleStore& mutableSamples(); // Bulk column appends by loaders
     std::string getId() const;
 
 private:
     std::string experimentId_;
-    std::vector<EcofunctionalSample> samples_;
+    EcofunctionalSampleStore samples_;
 };
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "domain.h"
+#include "feature_vector.h"
+
+using FeatureMatrix = std::vector<FeatureVector>;
+
+// Identity of an engineered feature matrix: which experiment (id plus a hash
+// of its sample columns, so edited data never hits a stale entry) and which
+// feature pipeline produced it.
+struct FeatureMatrixKey {
+    std::string experimentId;
+    uint64_t contentHash = 0;
+    uint64_t rowCount = 0;
+    int windowSize = 0; // Rolling window override, 0 for the pipeline's own windows
+    uint32_t pipelineVersion = FEATURE_PIPELINE_VERSION;
+
+    static FeatureMatrixKey forExperiment(const EcofunctionalExperiment& experiment,
+                                          int windowSize = 0);
+    std::string toString() const;
+    bool operator<(const FeatureMatrixKey& other) const;
+};
+
+// ==========================================
+// Feature Matrix Cache
+// ==========================================
+// Keeps engineered feature matrices in memory so repeated training runs on the
+// same experiment (hyperparameter sweeps) build the features once. With a
+// persist directory, matrices are also written there as
+// '<experimentId>-<hash>[-w<window>].v<version>.features' and reloaded on later runs.
+// Safe to share between threads; misses on different keys build concurrently.
+
+class FeatureMatrixCache {
+public:
+    explicit FeatureMatrixCache(std::string persistDirectory = "");
+
+    std::shared_ptr<const FeatureMatrix> get(const EcofunctionalExperiment& experiment,
+                                             int windowSize = 0);
+
+    size_t hits() const;
+    size_t misses() const;
+
+private:
+    std::string persistPath(const FeatureMatrixKey& key) const;
+    std::shared_ptr<const FeatureMatrix> loadPersisted(const FeatureMatrixKey& key) const;
+    void persist(const FeatureMatrixKey& key, const FeatureMatrix& matrix) const;
+
+    std::string persistDirectory_;
+    mutable std::mutex mutex_;
+    // Matrices are loaded or built outside the lock; a key being built is
+    // already present, so concurrent requests for it wait instead of rebuilding
+    std::map<FeatureMatrixKey, std::shared_future<std::shared_ptr<const FeatureMatrix>>> entries_;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+};
@@ -0,0 +1,240 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+constexpr size_t ECOVECTOR_SIZE = 10; // attributes in an EcofunctionalVector
+
+// ==========================================
+// Compile-time feature pipeline
+// ==========================================
+// A feature row is a list of blocks, each contributing one value per
+// attribute (block-major: [block 0 x 10][block 1 x 10]...). Blocks are
+// plain types, so the row width, the history the streaming state must keep
+// and the per-step update are all resolved at compile time: a block that is
+// not listed costs nothing, and the inner loops see constant sizes.
+//
+// A block provides, per attribute:
+//   WINDOW     the window or lag it is declared with
+//   LOOKBACK   past samples it reads at most
+//   WINDOWED   whether offline sweeps may override WINDOW
+//   LAYOUT_ID  identifies the block and its parameter in FEATURE_PIPELINE_VERSION
+//   Lane       running state of one attribute
+//   push(lane, x, past, t, window)  x is sample t (0-based), past(k) is sample t - k
+//                                   for 1 <= k <= min(t, LOOKBACK for 'window')
+//   value(lane)                     the feature after the last push
+
+namespace features {
+
+using Attributes = std::array<float, ECOVECTOR_SIZE>;
+
+// The sample itself
+struct Current {
+    static constexpr size_t WINDOW = 0;
+    static constexpr size_t LOOKBACK = 0;
+    static constexpr bool WINDOWED = false;
+    static constexpr uint32_t LAYOUT_ID = 0x100;
+
+    struct Lane {
+        float x = 0.0f;
+    };
+
+    template <class Past>
+    static void push(Lane& lane, float x, const Past&, size_t, size_t) { lane.x = x; }
+    static float value(const Lane& lane) { return lane.x; }
+};
+
+// x[t] - x[t - Lag]; zero until Lag samples have been seen
+template <size_t Lag>
+struct Delta {
+    static_assert(Lag >= 1, "Delta lag must be at least 1");
+    static constexpr size_t WINDOW = Lag;
+    static constexpr size_t LOOKBACK = Lag;
+    static constexpr bool WINDOWED = false;
+    static constexpr uint32_t LAYOUT_ID = 0x200 + static_cast<uint32_t>(Lag);
+
+    struct Lane {
+        float delta = 0.0f;
+    };
+
+    template <class Past>
+    static void push(Lane& lane, float x, const Past& past, size_t t, size_t) {
+        lane.delta = (t >= Lag) ? x - past(Lag) : 0.0f;
+    }
+    static float value(const Lane& lane) { return lane.delta; }
+};
+
+// Mean of the last Window samples (fewer while the window fills up),
+// recomputed over the window every step like RollingVariance so the float32
+// mean does not drift over long streams
+template <size_t Window>
+struct RollingMean {
+    static_assert(Window >= 1, "Rolling window must be at least 1");
+    static constexpr size_t WINDOW = Window;
+    static constexpr size_t LOOKBACK = Window - 1;
+    static constexpr bool WINDOWED = true;
+    static constexpr uint32_t LAYOUT_ID = 0x300 + static_cast<uint32_t>(Window);
+
+    struct Lane {
+        float mean = 0.0f;
+    };
+
+    template <class Past>
+    static void push(Lane& lane, float x, const Past& past, size_t t, size_t window) {
+        // Newest to oldest, the order calculateAverage sums in
+        const size_t previous = (t < window - 1) ? t : window - 1;
+        float sum = x;
+        for (size_t k = 1; k <= previous; ++k)
+            sum += past(k);
+        lane.mean = sum / static_cast<float>(previous + 1);
+    }
+    static float value(const Lane& lane) { return lane.mean; }
+};
+
+// Population variance of the last Window samples (fewer while the window fills
+// up). Recomputed in two passes over the window every step: Window is a small
+// compile-time constant, and unlike running sums (or Welford with eviction)
+// the float32 result does not drift over long streams.
+template <size_t Window>
+struct RollingVariance {
+    static_assert(Window >= 2, "Rolling variance needs a window of at least 2");
+    static constexpr size_t WINDOW = Window;
+    static constexpr size_t LOOKBACK = Window - 1;
+    static constexpr bool WINDOWED = true;
+    static constexpr uint32_t LAYOUT_ID = 0x400 + static_cast<uint32_t>(Window);
+
+    struct Lane {
+        float variance = 0.0f;
+    };
+
+    template <class Past>
+    static void push(Lane& lane, float x, const Past& past, size_t t, size_t window) {
+        const size_t previous = (t < window - 1) ? t : window - 1;
+        float sum = x;
+        for (size_t k = 1; k <= previous; ++k)
+            sum += past(k);
+        const float count = static_cast<float>(previous + 1);
+        const float mean = sum / count;
+        float squares = (x - mean) * (x - mean);
+        for (size_t k = 1; k <= previous; ++k)
+            squares += (past(k) - mean) * (past(k) - mean);
+        lane.variance = squares / count;
+    }
+    static float value(const Lane& lane) { return lane.variance; }
+};
+
+template <class... Blocks>
+struct FeaturePipeline {
+    static_assert(sizeof...(Blocks) > 0, "A feature pipeline needs at least one block");
+
+    static constexpr size_t BLOCKS = sizeof...(Blocks);
+    static constexpr size_t WIDTH = BLOCKS * ECOVECTOR_SIZE;
+    // Past samples the streaming state keeps for lags and window eviction
+    static constexpr size_t HISTORY = std::max({size_t{0}, Blocks::LOOKBACK...});
+    static constexpr size_t RING = HISTORY > 0 ? HISTORY : 1;
+
+    // Past samples a feature row reads when windowOverride > 0 replaces the
+    // window of the WINDOWED blocks (HISTORY for the pipeline's own windows)
+    static constexpr size_t lookback(size_t windowOverride) {
+        size_t rows = 0;
+        for (size_t block : {(Blocks::WINDOWED && windowOverride > 0) ? windowOverride - 1 : Blocks::LOOKBACK...})
+            rows = std::max(rows, block);
+        return rows;
+    }
+
+    static constexpr uint32_t layoutId() {
+        uint32_t id = 0;
+        for (uint32_t block : {Blocks::LAYOUT_ID...})
+            id = id * 31u + block;
+        return id;
+    }
+    static constexpr uint32_t LAYOUT_ID = layoutId();
+
+    using Row = std::array<float, WIDTH>;
+
+    // O(1)-per-step streaming state: every block's lanes plus a ring of the
+    // last HISTORY samples, so no caller needs to keep the history around.
+    struct State {
+        std::tuple<std::array<typename Blocks::Lane, ECOVECTOR_SIZE>...> lanes;
+        std::array<Attributes, RING> ring{};
+    };
+
+    // Advances the state with sample t (0-based count of samples pushed before it)
+    static void push(State& state, const Attributes& x, size_t t) {
+        pushBlocks(state, x, t, std::index_sequence_for<Blocks...>{});
+        if (HISTORY > 0) {
+            state.ring[t % RING] = x;
+        }
+    }
+
+    // Feature row after the last push
+    static void write(const State& state, float* row) {
+        writeBlocks(state, row, std::index_sequence_for<Blocks...>{});
+    }
+
+    // Features of every prefix of a column-major sample store, one attribute
+    // column at a time, with the same per-lane arithmetic as push/write.
+    // windowOverride > 0 replaces the window of the WINDOWED blocks.
+    template <class ColumnAt>
+    static void buildColumn(const ColumnAt& column, size_t n, size_t attribute, size_t windowOverride,
+                            Row* rows) {
+        buildColumnBlocks(column, n, attribute, windowOverride, rows, std::index_sequence_for<Blocks...>{});
+    }
+
+private:
+    template <size_t... B>
+    static void pushBlocks(State& state, const Attributes& x, size_t t, std::index_sequence<B...>) {
+        (pushBlock<Blocks>(std::get<B>(state.lanes), state, x, t), ...);
+    }
+
+    template <class Block>
+    static void pushBlock(std::array<typename Block::Lane, ECOVECTOR_SIZE>& lanes, const State& state,
+                          const Attributes& x, size_t t) {
+        for (size_t c = 0; c < ECOVECTOR_SIZE; ++c) {
+            auto past = [&](size_t k) { return state.ring[(t - k) % RING][c]; };
+            Block::push(lanes[c], x[c], past, t, Block::WINDOW);
+        }
+    }
+
+    template <size_t... B>
+    static void writeBlocks(const State& state, float* row, std::index_sequence<B...>) {
+        ((writeBlock<Blocks>(std::get<B>(state.lanes), row + B * ECOVECTOR_SIZE)), ...);
+    }
+
+    template <class Block>
+    static void writeBlock(const std::array<typename Block::Lane, ECOVECTOR_SIZE>& lanes, float* out) {
+        for (size_t c = 0; c < ECOVECTOR_SIZE; ++c)
+            out[c] = Block::value(lanes[c]);
+    }
+
+    template <class ColumnAt, size_t... B>
+    static void buildColumnBlocks(const ColumnAt& column, size_t n, size_t attribute, size_t windowOverride,
+                                  Row* rows, std::index_sequence<B...>) {
+        // One pass per column with every block's lane, so each row is touched once
+        const size_t windows[] = {(Blocks::WINDOWED && windowOverride > 0) ? windowOverride : Blocks::WINDOW...};
+        std::tuple<typename Blocks::Lane...> lanes{};
+        for (size_t i = 0; i < n; ++i) {
+            auto past = [&](size_t k) { return column[i - k]; };
+            const float x = column[i];
+            float* row = rows[i].data() + attribute;
+            ((Blocks::push(std::get<B>(lanes), x, past, i, windows[B]),
+              row[B * ECOVECTOR_SIZE] = Blocks::value(std::get<B>(lanes))), ...);
+        }
+    }
+};
+
+// Current state (10) + delta (10) + rolling average of 3 samples (10); the layout
+// caches and model files default to
+using DefaultFeaturePipeline = FeaturePipeline<Current, Delta<1>, RollingMean<3>>;
+
+} // namespace features
+
+// The layout used by training, inference, caches and model files. Replace it
+// to try richer features, e.g.
+//   features::FeaturePipeline<features::Current, features::Delta<1>, features::Delta<3>,
+//                             features::RollingMean<3>, features::RollingVariance<5>>
+// Row width, kernels and the pipeline version in cache/model files follow automatically.
+using ActiveFeaturePipeline = features::DefaultFeaturePipeline;
@@ -0,0 +1,35 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "feature_pipeline.h"
+
+// Width of a feature row, derived from ActiveFeaturePipeline
+// (default: current state (10) + delta (10) + rolling average (10))
+constexpr size_t ECOFEATURE_VECTOR_SIZE = ActiveFeaturePipeline::WIDTH;
+
+// Bump whenever the arithmetic of a feature block changes. Layout changes
+// (other blocks, windows or lags) are folded in from the pipeline's layout id,
+// so caches and models built for another layout are rejected.
+// 2: RollingMean recomputed over its window instead of a running sum
+constexpr uint32_t FEATURE_ARITHMETIC_VERSION = 2;
+
+// Equals FEATURE_ARITHMETIC_VERSION for the default layout
+constexpr uint32_t FEATURE_PIPELINE_VERSION =
+    ActiveFeaturePipeline::LAYOUT_ID == features::DefaultFeaturePipeline::LAYOUT_ID
+        ? FEATURE_ARITHMETIC_VERSION
+        : 0x80000000u | ((FEATURE_ARITHMETIC_VERSION * 0x9e3779b1u) ^ ActiveFeaturePipeline::LAYOUT_ID);
+
+// Fixed-size, stack-allocated feature row consumed by the Perceptron.
+// A std::vector<FeatureVector> is a contiguous row-major feature matrix.
+// Rows are deliberately not over-aligned: alignas(32) would pad the default
+// 120-byte row to 128 bytes, adding memory traffic to bandwidth-bound batch
+// scoring and changing the .features layout. The AVX2 kernels use unaligned
+// loads, which cost the same as aligned ones on AVX2 hardware; only the
+// reused weight row (Perceptron::weights_) is aligned.
+using FeatureVector = std::array<float, ECOFEATURE_VECTOR_SIZE>;
+static_assert(sizeof(FeatureVector) == ECOFEATURE_VECTOR_SIZE * sizeof(float),
+              "Feature matrices are densely packed rows");
+static_assert(std::is_same<FeatureVector, ActiveFeaturePipeline::Row>::value,
+              "Feature rows are the active pipeline's rows");
@@ -0,0 +1,50 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "domain.h"
+#include "perceptron.h"
+#include "thread_pool.h"
+
+class InferenceResultSink;
+
+struct PlotInferenceResult {
+    std::string plotId;
+    std::vector<InferenceOutput> steps; // One output per trajectory step
+};
+
+// What is left in memory when the steps are streamed to a sink
+struct PlotInferenceSummary {
+    std::string plotId;
+    size_t steps = 0;
+    InferenceOutput last{}; // Output of the final step
+};
+
+// ==========================================
+// Fleet Inference
+// ==========================================
+// Scores many independent plot trajectories concurrently. Each plot is one
+// task on the work-stealing pool and writes only its own result slot, so no
+// lock is taken while collecting results.
+
+constexpr size_t FLEET_SINK_CHUNK = 4096;
+
+class FleetInferenceEngine {
+public:
+    // threads == 0 uses all hardware threads
+    explicit FleetInferenceEngine(size_t threads = 0);
+
+    std::vector<PlotInferenceResult> run(const Perceptron& model,
+                                         const std::vector<PlotTrajectory>& plots);
+
+    // Streams every step to 'sink' in chunks of FLEET_SINK_CHUNK steps per plot,
+    // so memory stays bounded however long the trajectories are. Plots are
+    // interleaved in completion order; each plot's steps stay in order.
+    // Every chunk is encoded under the sink's single mutex, so with many
+    // threads the sink, not scoring, bounds the throughput.
+    std::vector<PlotInferenceSummary> run(const Perceptron& model,
+                                          const std::vector<PlotTrajectory>& plots,
+                                          InferenceResultSink& sink);
+
+private:
+    ThreadPool pool_;
+};
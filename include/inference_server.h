@@ -0,0 +1,136 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "domain.h"
+#include "perceptron.h"
+
+// ==========================================
+// Inference Server
+// ==========================================
+// Long-running scoring of per-plot sample streams with a model loaded once.
+// Requests from any number of clients go through one queue; a batcher thread
+// takes everything queued (up to maxBatch), advances each plot's streaming
+// feature state in arrival order and scores the whole batch with one
+// Perceptron::inferBatchScalar call, bit-identical to the offline tools.
+// Under light load a batch is a single request, so latency stays at one
+// scoring step; under load batches grow on their own.
+
+struct InferenceServerOptions {
+    size_t maxBatch = 256;
+    // Extra wait for more requests once one is queued; 0 batches only what is already waiting
+    std::chrono::microseconds batchWindow{0};
+};
+
+struct InferenceServerStats {
+    size_t requests = 0;
+    size_t batches = 0;
+    size_t largestBatch = 0;
+    size_t plots = 0;
+};
+
+// Where the replies of one client go. Replies arrive in request order, on the
+// batcher thread; flush() is called once per batch for every channel it touched.
+class InferenceReplyChannel {
+public:
+    virtual ~InferenceReplyChannel() = default;
+
+    virtual void reply(std::string_view plotId, size_t step, const InferenceOutput& output) = 0;
+    // Any non-inference reply (errors, acknowledgements, stats), one JSON object
+    virtual void replyJson(const std::string& json) = 0;
+    virtual void flush() {}
+};
+
+class InferenceBatcher {
+public:
+    explicit InferenceBatcher(const Perceptron& model, InferenceServerOptions options = {});
+    ~InferenceBatcher();
+
+    InferenceBatcher(const InferenceBatcher&) = delete;
+    InferenceBatcher& operator=(const InferenceBatcher&) = delete;
+
+    // Appends 'sample' to the plot's stream (created on first use) and replies
+    // with the output at that step (0-based step count of the plot)
+    void submit(std::string plotId, const EcofunctionalVector& sample,
+                std::shared_ptr<InferenceReplyChannel> channel);
+    // Forgets the plot's stream after the samples already queued; replies {"reset":...}
+    void resetPlot(std::string plotId, std::shared_ptr<InferenceReplyChannel> channel);
+    // Replies with InferenceServerStats as JSON, in order with the other replies
+    void requestStats(std::shared_ptr<InferenceReplyChannel> channel);
+    // Replies with {"error":...}, in order with the other replies
+    void reportError(std::string message, std::shared_ptr<InferenceReplyChannel> channel);
+
+    // Blocks until every request queued so far has been replied to
+    void drain();
+
+    InferenceServerStats stats() const;
+
+private:
+    enum class RequestKind { SAMPLE, RESET, STATS, ERROR };
+
+    struct Request {
+        RequestKind kind;
+        std::string plotId; // Error message for ERROR
+        EcofunctionalVector sample;
+        std::shared_ptr<InferenceReplyChannel> channel;
+    };
+
+    void enqueue(Request request);
+    void run();
+    void process(std::vector<Request>& batch);
+
+    const Perceptron model_;
+    const InferenceServerOptions options_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    std::deque<Request> queue_;
+    bool busy_ = false;
+    bool stopping_ = false;
+    InferenceServerStats stats_;
+
+    // Batcher thread only
+    // Only the streaming features are read, so plots keep no sample history
+    std::unordered_map<std::string, EcofunctionalFeatureState> plots_;
+    // One entry per sample of the batch, captured right after it was added to its plot
+    std::vector<FeatureVector> rows_;
+    std::vector<float> scores_;
+    std::vector<float> vegetationTrends_;
+    std::vector<size_t> steps_; // Samples the plot had seen, this one included
+    std::vector<EcofunctionalTrajectory::TrajectoryState> states_;
+    std::vector<InferenceOutput> outputs_;
+
+    std::thread worker_;
+};
+
+// ------------------------------------------
+// Line protocol and transports
+// ------------------------------------------
+// One request per line, one reply line per request, in order:
+//   <plotId>,<10 attributes>   sample (the fleet CSV row layout)   -> NdjsonResultSink line
+//   !reset <plotId>            forget the plot's stream            -> {"plot_id":...,"reset":true}
+//   !stats                     server counters                     -> {"requests":...,"batches":...}
+// Malformed lines reply {"error":...}. Blank lines are ignored.
+
+// Parses one protocol line and queues it on 'batcher'
+void submitProtocolLine(InferenceBatcher& batcher, std::string_view line,
+                        const std::shared_ptr<InferenceReplyChannel>& channel);
+
+// Serves requests read from 'in' (e.g. a stdin pipe) until end of input, replying on 'out'
+void serveStream(InferenceBatcher& batcher, std::istream& in, std::ostream& out);
+
+// Listens on a Unix domain socket at 'path' (replacing a stale socket file)
+// with one reader thread per client, until 'stop' becomes true.
+// Throws std::runtime_error where Unix sockets are unavailable.
+void serveUnixSocket(InferenceBatcher& batcher, const std::string& path, const std::atomic<bool>& stop);
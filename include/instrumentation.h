@@ -0,0 +1,80 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// ==========================================
+// Instrumentation
+// ==========================================
+// Scoped stage timers and event counters for the pipeline hot paths:
+//
+//   ECO_TIME_SCOPE("train");          // times the enclosing scope
+//   ECO_COUNT("infer.steps", n);       // adds n to a counter
+//
+// Each call site resolves its name to a slot once (function-local static);
+// afterwards recording touches only thread-local storage, with no lock and
+// no shared cache line. Place timers around batches, not single rows.
+// Totals are aggregated over threads when reported, which must happen while
+// no instrumented work is running (e.g. at exit).
+//
+// Configuring with -DECOPERCEPTRON_INSTRUMENTATION=OFF compiles every macro
+// to nothing; the reporting functions then print a short notice.
+
+namespace instrumentation {
+
+// Also records every timed scope as a Chrome trace event (bounded per thread)
+void enableTracing(bool enabled);
+
+// Per stage: calls, total/mean/max time and number of threads; then counters
+void writeSummary(std::ostream& out);
+
+// Chrome trace event format, viewable in chrome://tracing or Perfetto.
+// Throws std::runtime_error if the file cannot be written.
+void writeChromeTrace(const std::string& path);
+
+#ifndef ECOPERCEPTRON_DISABLE_INSTRUMENTATION
+
+size_t registerStage(const char* name);
+size_t registerCounter(const char* name);
+
+void addCount(size_t counter, uint64_t value);
+
+class ScopedTimer {
+public:
+    explicit ScopedTimer(size_t stage);
+    ~ScopedTimer();
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    size_t stage_;
+    int64_t startNs_;
+};
+
+#endif
+
+} // namespace instrumentation
+
+#ifndef ECOPERCEPTRON_DISABLE_INSTRUMENTATION
+
+#define ECO_INSTR_CONCAT_(a, b) a##b
+#define ECO_INSTR_CONCAT(a, b) ECO_INSTR_CONCAT_(a, b)
+
+#define ECO_TIME_SCOPE(name)                                                                        \
+    static const size_t ECO_INSTR_CONCAT(ecoStage_, __LINE__) = instrumentation::registerStage(name); \
+    instrumentation::ScopedTimer ECO_INSTR_CONCAT(ecoTimer_, __LINE__)(ECO_INSTR_CONCAT(ecoStage_, __LINE__))
+
+#define ECO_COUNT(name, value)                                                                         \
+    do {                                                                                               \
+        static const size_t ecoCounter_ = instrumentation::registerCounter(name);                      \
+        instrumentation::addCount(ecoCounter_, static_cast<uint64_t>(value));                           \
+    } while (0)
+
+#else
+
+#define ECO_TIME_SCOPE(name) ((void)0)
+#define ECO_COUNT(name, value) ((void)0)
+
+#endif
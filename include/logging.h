@@ -0,0 +1,46 @@
+#pragma once
+#include <sstream>
+#include <string>
+
+// ==========================================
+// Logging
+// ==========================================
+// Level-filtered log lines. INFO and DEBUG go to std::cout without a flush
+// per line (the stream's own buffering applies); WARN and ERROR flush
+// std::cout first, so ordering is kept, and go to std::cerr. Filtered-out
+// messages are not formatted at all.
+//
+//   ECO_LOG_INFO("[DataLoader] Loaded " << n << " samples");
+
+enum class LogLevel {
+    ERROR = 0,
+    WARN = 1,
+    INFO = 2,
+    DEBUG = 3
+};
+
+void setLogLevel(LogLevel level);
+LogLevel logLevel();
+bool logEnabled(LogLevel level);
+
+// Parses "error", "warn", "info" or "debug"; throws std::invalid_argument otherwise
+LogLevel parseLogLevel(const std::string& name);
+
+// Writes one complete line; safe to call from several threads
+void logLine(LogLevel level, const std::string& line);
+
+void flushLog();
+
+#define ECO_LOG(level, message)                         \
+    do {                                                \
+        if (logEnabled(level)) {                        \
+            std::ostringstream ecoLogStream_;           \
+            ecoLogStream_ << message;                   \
+            logLine(level, ecoLogStream_.str());        \
+        }                                               \
+    } while (0)
+
+#define ECO_LOG_ERROR(message) ECO_LOG(LogLevel::ERROR, message)
+#define ECO_LOG_WARN(message) ECO_LOG(LogLevel::WARN, message)
+#define ECO_LOG_INFO(message) ECO_LOG(LogLevel::INFO, message)
+#define ECO_LOG_DEBUG(message) ECO_LOG(LogLevel::DEBUG, message)
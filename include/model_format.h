@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "feature_vector.h"
+#include "mapped_file.h"
+
+// ==========================================
+// Binary model format (.ecomodel)
+// ==========================================
+// Layout: a fixed ModelFileHeader followed, at 'payloadOffset' (aligned to
+// MODEL_ALIGNMENT), by 'inputSize' float32 weights and the float32 bias.
+// The checksum is FNV-1a over the payload bytes. Values are stored in host
+// byte order (little-endian on supported targets). The file is
+// memory-mapped and the weights are read in place.
+
+constexpr char MODEL_MAGIC[8] = {'E', 'C', 'O', 'M', 'O', 'D', 'L', '\0'};
+constexpr uint32_t MODEL_FORMAT_VERSION = 1;
+constexpr size_t MODEL_ALIGNMENT = 64;
+
+struct ModelFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t inputSize;
+    uint32_t pipelineVersion; // FEATURE_PIPELINE_VERSION the weights were trained against
+    uint32_t flags;           // Reserved, 0
+    uint64_t payloadOffset;
+    uint64_t checksum;
+    uint8_t reserved[24];
+};
+static_assert(sizeof(ModelFileHeader) == MODEL_ALIGNMENT, "Header must keep the weights aligned");
+
+// Writes through a temporary file and a rename, so readers never see a partial model
+void writeModelFile(const std::string& path, const float* weights, size_t inputSize, float bias);
+
+// Read-only, zero-copy view of a memory-mapped model file
+class ModelFile {
+public:
+    // Throws std::runtime_error if the file cannot be opened, is malformed,
+    // fails its checksum or was built for another input size or feature pipeline
+    void open(const std::string& path);
+    // False until open() succeeds; the accessors below require an open file
+    bool isOpen() const { return header_ != nullptr; }
+
+    size_t inputSize() const { return header_->inputSize; }
+    uint32_t pipelineVersion() const { return header_->pipelineVersion; }
+    const float* weights() const { return payload_; }
+    float bias() const { return payload_[header_->inputSize]; }
+
+private:
+    MappedFile file_;
+    const ModelFileHeader* header_ = nullptr;
+    const float* payload_ = nullptr;
+};
+
+// True for paths ending in ".ecomodel"; every other path is a JSON model
+bool isBinaryModelPath(const std::string& path);
@@ -1,23 +1,113 @@
 #pragma once
 #include <vector>
 #include <string>
+#include <functional>
+#include "feature_vector.h"
+
+class ThreadPool;
+class ModelFile;
+
+enum class ParallelMode {
+    SYNCHRONOUS, // Each mini-batch is sharded, shard gradients are reduced in shard order (deterministic)
+    HOGWILD      // Workers run lock-free per-sample SGD on their shard against shared weights (non-deterministic)
+};
+
+// Per-epoch telemetry passed to TrainingOptions::onEpoch
+struct TrainingEpochStats {
+    int epoch;               // 1-based
+    float loss;              // Mean squared error of the epoch, measured on the fly before each update
+    float validationLoss;    // Mean squared error on the validation set, NaN without one
+    double wallSeconds;      // Since training started
+    double samplesPerSecond; // Throughput of this epoch
+};
+
+// Held-out rows used for validation-based early stopping
+struct ValidationSet {
+    const FeatureVector* X = nullptr;
+    const float* y = nullptr;
+    size_t count = 0;
+};
+
+struct TrainingOptions {
+    float learningRate = 0.1f;
+    int epochs = 2000; // Upper bound when early stopping is enabled
+    size_t batchSize = 1; // 1 = classic per-sample SGD; larger values use averaged mini-batch gradients
+    size_t threads = 1;   // > 1 enables data-parallel training in 'parallelMode'
+    ParallelMode parallelMode = ParallelMode::SYNCHRONOUS;
+
+    // Early stopping. With a validation set, training stops once the validation
+    // loss has not improved by more than 'tolerance' for 'patience' epochs and
+    // the best weights are restored. Without one, a tolerance > 0 stops on the
+    // same rule applied to the training loss. Not available in HOGWILD mode.
+    float tolerance = 0.0f;
+    int patience = 1;
+    ValidationSet validation;
+
+    // Called after every epoch; returning false stops training
+    std::function<bool(const TrainingEpochStats&)> onEpoch;
+};
+
+struct TrainingReport {
+    int epochsRun = 0;
+    float finalLoss = 0.0f;
+    float bestValidationLoss = 0.0f; // NaN without a validation set
+    bool stoppedEarly = false;
+    double wallSeconds = 0.0;
+};
 
 class Perceptron {
 public:
-    Perceptron(size_t inputSize);
+    Perceptron();
+
+    static constexpr size_t inputSize() { return ECOFEATURE_VECTOR_SIZE; }
+    const FeatureVector& weights() const { return weights_; }
+    float bias() const { return bias_; }
 
-    float infer(const std::vector<float>& x) const;
-    void train(const std::vector<std::vector<float>>& X,
-               const std::vector<float>& y,
-               float lr,
-               int epochs);
+    float infer(const FeatureVector& x) const;
+    // Scores 'count' contiguous rows in one call using the vectorized kernel
+    void inferBatch(const FeatureVector* rows, size_t count, float* out) const;
+    std::vector<float> inferBatch(const std::vector<FeatureVector>& rows) const;
+    // Scalar kernel only: bit-identical to infer() row by row, unlike the AVX2
+    // kernel's approximate exp. For batches whose scores must match per-step tools.
+    void inferBatchScalar(const FeatureVector* rows, size_t count, float* out) const;
+    TrainingReport train(const std::vector<FeatureVector>& X,
+                         const std::vector<float>& y,
+                         float lr,
+                         int epochs);
+    TrainingReport train(const std::vector<FeatureVector>& X,
+                         const std::vector<float>& y,
+                         const TrainingOptions& options);
+    // Contiguous feature matrix of 'count' rows with one label per row
+    TrainingReport train(const FeatureVector* X, const float* y, size_t count,
+                         const TrainingOptions& options);
 
+    // Single SGD step on one labelled row; returns the error before the update
+    float update(const FeatureVector& x, float y, float lr);
+
+    // Binary model format (model_format.h) for paths ending in ".ecomodel", JSON otherwise
     void save(const std::string& path) const;
     void load(const std::string& path);
+    // Human-readable export: {"weights": [...], "bias": ..., "pipeline_version": ...}
+    void saveJson(const std::string& path) const;
+    void loadJson(const std::string& path);
+    // Copies the weights out of an already opened (memory-mapped) model file;
+    // throws std::runtime_error if it is not open
+    void load(const ModelFile& file);
 
 private:
-    std::vector<float> weights_;
+    alignas(32) FeatureVector weights_{};
     float bias_;
 
     static float sigmoid(float z);
+
+    // Each epoch returns its sum of squared errors (pre-update predictions)
+    double trainEpochSgd(const FeatureVector* X, const float* y, size_t count, float lr);
+    double trainEpochMiniBatch(const FeatureVector* X, const float* y, size_t count,
+                               size_t batchSize, float lr, std::vector<float>& predictions);
+    double trainEpochSynchronous(const FeatureVector* X, const float* y, size_t count,
+                                 size_t batchSize, float lr, std::vector<float>& predictions,
+                                 ThreadPool& pool);
+    TrainingReport trainHogwild(const FeatureVector* X, const float* y, size_t count,
+                                const TrainingOptions& options);
+    float meanSquaredError(const FeatureVector* X, const float* y, size_t count) const;
 };
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "feature_vector.h"
+
+// ==========================================
+// Batched scoring kernels behind Perceptron
+// ==========================================
+// The AVX2/FMA kernel is selected once at runtime when the CPU supports it;
+// the scalar kernel is always built and is used otherwise, or everywhere when
+// the project is configured with ECOPERCEPTRON_FORCE_SCALAR.
+
+namespace kernels {
+
+enum class KernelIsa {
+    SCALAR,
+    AVX2
+};
+
+KernelIsa activeIsa();
+const char* isaName(KernelIsa isa);
+
+// out[i] = sigmoid(bias + dot(weights, rows[i])) for i in [0, count).
+// 'rows' is a contiguous row-major matrix of 'count' feature vectors.
+void scoreBatch(const FeatureVector& weights, float bias,
+                const FeatureVector* rows, size_t count, float* out);
+
+// Reference implementation; bit-identical to Perceptron::infer row by row.
+void scoreBatchScalar(const FeatureVector& weights, float bias,
+                      const FeatureVector* rows, size_t count, float* out);
+
+// gradient[j] += sum_i errors[i] * rows[i][j]; written so the compiler vectorizes the inner loop
+void accumulateGradient(const FeatureVector* rows, const float* errors, size_t count,
+                        FeatureVector& gradient);
+
+// ------------------------------------------
+// Quantized scoring (see quantized.h)
+// ------------------------------------------
+// Quantized rows and weights are padded to QUANTIZED_ROW_WIDTH lanes (the
+// feature width rounded up to a multiple of 32); the padding lanes of the
+// weights must be zero.
+constexpr size_t QUANTIZED_ROW_WIDTH = (ECOFEATURE_VECTOR_SIZE + 31) / 32 * 32;
+
+// out[i] = sigmoid(bias + weightScale * sum_j weights[j] * rows[i][j]),
+// with the dot product accumulated exactly in int32.
+void scoreBatchInt8(const int8_t* weights, float weightScale, float bias,
+                    const int8_t* rows, size_t count, float* out);
+void scoreBatchInt8Scalar(const int8_t* weights, float weightScale, float bias,
+                          const int8_t* rows, size_t count, float* out);
+
+// IEEE half precision operands, accumulated in float32
+void scoreBatchFp16(const uint16_t* weights, float bias,
+                    const uint16_t* rows, size_t count, float* out);
+void scoreBatchFp16Scalar(const uint16_t* weights, float bias,
+                          const uint16_t* rows, size_t count, float* out);
+
+// Round-to-nearest-even conversions, matching the F16C instructions
+uint16_t floatToHalf(float value);
+float halfToFloat(uint16_t value);
+
+} // namespace kernels
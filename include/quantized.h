@@ -0,0 +1,67 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "feature_vector.h"
+#include "perceptron.h"
+#include "perceptron_kernels.h"
+
+// ==========================================
+// Quantized inference
+// ==========================================
+// Read-only copy of a trained Perceptron whose weights and input rows are
+// stored as int8 or IEEE fp16, so batched scoring moves 4x (int8) or 2x (fp16)
+// fewer bytes per feature than float32.
+//   - INT8: every feature j is stored as round(x_j / featureScale_j), with the
+//     scale calibrated from representative rows (max |x_j| maps to 127). The
+//     weights are folded with those scales and share one scale of their own,
+//     so a row scores with a single int32 dot product.
+//   - FP16: weights and features are rounded to half precision; no calibration.
+// Rows are padded to kernels::QUANTIZED_ROW_WIDTH lanes.
+
+enum class QuantizationMode {
+    INT8,
+    FP16
+};
+
+const char* quantizationModeName(QuantizationMode mode);
+
+// Quantized feature rows, row-major with QUANTIZED_ROW_WIDTH lanes per row
+struct QuantizedMatrix {
+    QuantizationMode mode = QuantizationMode::INT8;
+    size_t rows = 0;
+    std::vector<int8_t> int8Data;   // INT8 mode
+    std::vector<uint16_t> fp16Data; // FP16 mode
+
+    size_t bytes() const { return int8Data.size() * sizeof(int8_t) + fp16Data.size() * sizeof(uint16_t); }
+};
+
+class QuantizedPerceptron {
+public:
+    // INT8 requires calibration rows (typically a sample of the data to be
+    // scored); values beyond the calibrated range saturate. FP16 ignores them.
+    static QuantizedPerceptron fromModel(const Perceptron& model, QuantizationMode mode,
+                                         const FeatureVector* calibration = nullptr,
+                                         size_t calibrationCount = 0);
+
+    QuantizationMode mode() const { return mode_; }
+
+    QuantizedMatrix quantize(const FeatureVector* rows, size_t count) const;
+    void scoreBatch(const QuantizedMatrix& rows, float* out) const;
+    // Quantizes and scores in one call; convenient, but the bandwidth win
+    // comes from keeping quantized matrices around and scoring those.
+    void inferBatch(const FeatureVector* rows, size_t count, float* out) const;
+
+private:
+    QuantizationMode mode_ = QuantizationMode::INT8;
+    float bias_ = 0.0f;
+
+    // INT8
+    std::array<float, ECOFEATURE_VECTOR_SIZE> inverseFeatureScale_{};
+    alignas(32) std::array<int8_t, kernels::QUANTIZED_ROW_WIDTH> int8Weights_{};
+    float weightScale_ = 0.0f;
+
+    // FP16
+    alignas(32) std::array<uint16_t, kernels::QUANTIZED_ROW_WIDTH> fp16Weights_{};
+};
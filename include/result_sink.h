@@ -0,0 +1,133 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "domain.h"
+
+// ==========================================
+// Inference Result Sinks
+// ==========================================
+// Write per-step inference outputs as they are produced, through a fixed
+// size buffer, so memory does not grow with the number of steps. Shared by
+// the single trajectory replay and the fleet engine; write() may be called
+// from several threads, and the steps passed in one call stay contiguous.
+// Calls are serialized on one mutex that is held while the records are
+// encoded, so concurrent writers do not scale: the fleet amortizes it by
+// writing FLEET_SINK_CHUNK steps per call.
+
+class InferenceResultSink {
+public:
+    virtual ~InferenceResultSink() = default;
+
+    InferenceResultSink(const InferenceResultSink&) = delete;
+    InferenceResultSink& operator=(const InferenceResultSink&) = delete;
+
+    // Consecutive steps of one plot, starting at 'firstStep' (an empty plotId for a lone trajectory)
+    void write(std::string_view plotId, size_t firstStep, const InferenceOutput* outputs, size_t count);
+    void write(std::string_view plotId, size_t step, const InferenceOutput& output) {
+        write(plotId, step, &output, 1);
+    }
+
+    // Flushes and finalizes the file; further writes are an error. Also run by the destructor.
+    void close();
+
+    size_t rowsWritten() const;
+
+protected:
+    explicit InferenceResultSink(size_t bufferBytes) : bufferBytes_(bufferBytes) {}
+
+    // Called with the mutex held
+    virtual void append(std::string_view plotId, size_t firstStep, const InferenceOutput* outputs, size_t count) = 0;
+    virtual void finish() = 0;
+
+    const size_t bufferBytes_;
+
+private:
+    mutable std::mutex mutex_;
+    size_t rows_ = 0;
+    bool closed_ = false;
+};
+
+constexpr size_t RESULT_SINK_BUFFER_BYTES = 1 << 20;
+
+// One NdjsonResultSink line (newline included), for other NDJSON writers
+void appendNdjsonResult(std::string& out, std::string_view plotId, size_t step, const InferenceOutput& output);
+// Quoted, escaped JSON string
+void appendJsonString(std::string& out, std::string_view text);
+
+// One JSON object per line:
+// {"plot_id":"PLOT-A","step":0,"functional_integrity":...,"recovery_capacity":...,"resilience_potential":...}
+// "plot_id" is omitted for a lone trajectory.
+class NdjsonResultSink : public InferenceResultSink {
+public:
+    explicit NdjsonResultSink(const std::string& path, size_t bufferBytes = RESULT_SINK_BUFFER_BYTES);
+    ~NdjsonResultSink() override;
+
+protected:
+    void append(std::string_view plotId, size_t firstStep, const InferenceOutput* outputs, size_t count) override;
+    void finish() override;
+
+private:
+    void flushBuffer();
+
+    std::ofstream out_;
+    std::string buffer_;
+    std::string path_;
+};
+
+// Binary results file (.ecores): a ResultFileHeader, fixed-size ResultRecords
+// in arrival order, then the plot id table (per plot a uint32 length and its
+// bytes) that ResultRecord::plotIndex refers to. Host byte order.
+constexpr char RESULT_FILE_MAGIC[8] = {'E', 'C', 'O', 'R', 'S', 'L', 'T', '\0'};
+constexpr uint32_t RESULT_FILE_VERSION = 2; // 2: 64-bit steps
+
+struct ResultFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t recordCount;
+    uint64_t plotTableOffset;
+    uint32_t plotCount;
+    uint8_t reserved[28];
+};
+static_assert(sizeof(ResultFileHeader) == 64, "Result header layout is part of the file format");
+
+struct ResultRecord {
+    uint64_t step; // size_t steps are stored whole; 2^32 steps and more do not wrap
+    uint32_t plotIndex;
+    float functionalIntegrity;
+    float recoveryCapacity;
+    float resiliencePotential;
+};
+static_assert(sizeof(ResultRecord) == 24, "Result record layout is part of the file format");
+
+class BinaryResultSink : public InferenceResultSink {
+public:
+    explicit BinaryResultSink(const std::string& path, size_t bufferBytes = RESULT_SINK_BUFFER_BYTES);
+    ~BinaryResultSink() override;
+
+protected:
+    void append(std::string_view plotId, size_t firstStep, const InferenceOutput* outputs, size_t count) override;
+    void finish() override;
+
+private:
+    uint32_t plotIndex(std::string_view plotId);
+    void flushBuffer();
+
+    std::ofstream out_;
+    std::vector<ResultRecord> buffer_;
+    std::unordered_map<std::string, uint32_t> plotIndices_;
+    std::vector<std::string> plotIds_;
+    uint64_t recordCount_ = 0;
+    std::string path_;
+};
+
+// Binary sink for paths ending in ".ecores", NDJSON otherwise; throws std::runtime_error
+// if the file cannot be created
+std::unique_ptr<InferenceResultSink> openResultSink(const std::string& path);
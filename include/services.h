@@ -2,8 +2,23 @@
 #include "domain.h"
 #include "perceptron.h"
 #include "dataset.h"
+#include "feature_vector.h"
+#include <array>
+#include <functional>
 
-constexpr size_t ECOFEATURE_VECTOR_SIZE = 30; // current state (10) + delta (10) + rolling average (10)
+class FeatureMatrixCache;
+
+// ==========================================
+// Feature Engineering
+// ==========================================
+
+// Feature rows for every prefix of 'samples', i.e. row i equals the features
+// of a trajectory holding samples [0, i]. Computed column by column over the
+// store; with windowSize 0 (the pipeline's own windows) it is bit-identical to
+// the streaming EcofunctionalFeatureState. A positive windowSize replaces the
+// window of every rolling block, for offline evaluation (sweeps).
+std::vector<FeatureVector> buildFeatureMatrix(const EcofunctionalSampleStore& samples,
+                                              int windowSize = 0);
 
 // ==========================================
 // Domain Services
@@ -11,16 +26,81 @@ constexpr size_t ECOFEATURE_VECTOR_SIZE = 30; // current state (10) + delta (10)
 
 class PerceptronTrainingService {
 public:
+    // With a cache, engineered feature matrices are reused across training runs
+    explicit PerceptronTrainingService(FeatureMatrixCache* featureCache = nullptr);
+
     // Trains a perceptron model using the experiment's data
-    void trainFullExperiment(Perceptron& model, 
-                             const EcofunctionalExperiment& experiment, 
-                             float learningRate, 
-                             int epochs);
+    TrainingReport trainFullExperiment(Perceptron& model, 
+                                       const EcofunctionalExperiment& experiment, 
+                                       float learningRate, 
+                                       int epochs);
+    TrainingReport trainFullExperiment(Perceptron& model,
+                                       const EcofunctionalExperiment& experiment,
+                                       const TrainingOptions& options);
+
+private:
+    FeatureMatrixCache* featureCache_;
+};
+
+// Updates a model in place as labelled samples arrive on a trajectory stream.
+// Only the streaming feature state (with its window of past samples) is kept,
+// so memory stays constant however long the stream runs.
+class PerceptronOnlineLearningService {
+public:
+    explicit PerceptronOnlineLearningService(Perceptron& model, float learningRate = 0.1f);
+
+    // Advances the feature state with the sample and applies one SGD step on its
+    // label, using the same features as offline training. Returns the error
+    // of the prediction made before the update.
+    float observe(const EcofunctionalSample& sample);
+
+    // Starts a new stream (e.g. another plot); the model keeps what it learned
+    void resetStream();
+
+    const EcofunctionalFeatureState& featureState() const { return state_; }
+    size_t samplesSeen() const { return samplesSeen_; }
+    // Exponential moving average of the squared pre-update error
+    float recentLoss() const { return recentLoss_; }
+
+private:
+    Perceptron& model_;
+    float learningRate_;
+    EcofunctionalFeatureState state_;
+    size_t samplesSeen_ = 0;
+    float recentLoss_ = 0.0f;
 };
 
 class PerceptronInferenceService {
 public:
+    // Scores above this count as high functional integrity in interpretScore
+    static constexpr float HIGH_INTEGRITY_THRESHOLD = 0.7f;
+
     // Uses a trained model to infer ecofunctional properties
     InferenceOutput inferState(const Perceptron& model, 
                                const EcofunctionalTrajectory& trajectory);
+
+    // Same as inferState, from a streaming feature state (trajectory, cursor or stream)
+    InferenceOutput inferFromFeatureState(const Perceptron& model,
+                                          const EcofunctionalFeatureState& state);
+
+    // Recovery capacity and resilience from a model score and the trajectory state
+    // it was computed at. Outputs match inferState only if the score does: score
+    // with infer or inferBatchScalar, not the approximate AVX2 inferBatch.
+    static InferenceOutput interpretScore(float functionalIntegrity,
+                                          EcofunctionalTrajectory::TrajectoryState state,
+                                          float vegetationTrend);
+    // interpretScore for 'count' steps at once, element by element identical to it
+    // for the same inputs; branch-free so the loop vectorizes (pairs with classifyStates)
+    static void interpretScores(const float* functionalIntegrity,
+                                const EcofunctionalTrajectory::TrajectoryState* states,
+                                const float* vegetationTrends, size_t count, InferenceOutput* out);
+
+    // Per-step outputs for a whole trajectory in one O(n) pass; identical to calling
+    // inferState on every growing prefix, without building those prefixes.
+    std::vector<InferenceOutput> replay(const Perceptron& model,
+                                        const EcofunctionalTrajectory& trajectory);
+    // Streaming form: hands each step to 'onStep' (0-based step) instead of collecting them
+    void replay(const Perceptron& model,
+                const EcofunctionalTrajectory& trajectory,
+                const std::function<void(size_t step, const InferenceOutput& output)>& onStep);
 };
@@ -0,0 +1,46 @@
+#pragma once
+#include <vector>
+#include "domain.h"
+#include "perceptron.h"
+#include "thread_pool.h"
+
+class FeatureMatrixCache;
+
+// Hyperparameter grid; every combination is evaluated with k-fold cross-validation
+struct SweepGrid {
+    std::vector<float> learningRates{0.1f};
+    std::vector<int> epochs{2000};
+    std::vector<int> windowSizes{0}; // Rolling block window of the feature matrix; 0 keeps the pipeline windows
+    size_t folds = 5;
+    size_t batchSize = 1;
+};
+
+struct SweepResult {
+    float learningRate;
+    int epochs;
+    int windowSize;
+    float meanValidationMse;
+    float stdValidationMse;
+    std::vector<float> foldMse;
+};
+
+// ==========================================
+// Hyperparameter Sweep / Cross-Validation
+// ==========================================
+// Trains one Perceptron per (configuration, fold) concurrently on a thread
+// pool. Folds are contiguous blocks of rows, which respects the temporal
+// order of the samples; all tasks read the same shared, read-only feature
+// matrix per window size.
+
+class HyperparameterSweep {
+public:
+    // threads == 0 uses all hardware threads; an optional cache shares matrices with training runs
+    explicit HyperparameterSweep(size_t threads = 0, FeatureMatrixCache* featureCache = nullptr);
+
+    // Results sorted by mean validation MSE, best first
+    std::vector<SweepResult> run(const EcofunctionalExperiment& experiment, const SweepGrid& grid);
+
+private:
+    ThreadPool pool_;
+    FeatureMatrixCache* featureCache_;
+};
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "domain.h"
+
+// ==========================================
+// Synthetic Ecosystem Data
+// ==========================================
+// Generates plausible plot trajectories for scale and performance testing.
+// Each plot follows a latent functional health driven by a regime process
+// (stable, degrading, collapsing, recovering); vegetation tracks health
+// quickly, soil slowly and is rebuilt more slowly than it is lost, which
+// gives recovery paths their hysteresis. The 10 attributes are derived from
+// those latent states plus observation noise, and the label is a functional
+// integrity index in [0, 1].
+//
+// Output depends only on (seed, plot index, step): a plot can be generated
+// on its own, in any order, with the same result. The random number
+// generator and its normal deviates are implemented here rather than taken
+// from <random>, whose distributions differ between standard libraries.
+// Box-Muller still calls std::log, std::cos and std::sin, which are not
+// correctly rounded, so identical output is only guaranteed with the same libm.
+
+enum class EcosystemRegime {
+    STABLE,
+    DEGRADING,
+    COLLAPSING,
+    RECOVERING
+};
+
+const char* ecosystemRegimeName(EcosystemRegime regime);
+
+// xoshiro256** seeded through splitmix64
+class SyntheticRng {
+public:
+    explicit SyntheticRng(uint64_t seed);
+
+    uint64_t nextU64();
+    float uniform();               // [0, 1)
+    float normal(float stddev);    // Box-Muller, mean 0
+
+private:
+    uint64_t state_[4];
+    float spareNormal_ = 0.0f;
+    bool hasSpare_ = false;
+};
+
+class SyntheticPlotGenerator {
+public:
+    SyntheticPlotGenerator(uint64_t seed, size_t plotIndex);
+
+    // Next time step; targetLabel holds the functional integrity
+    EcofunctionalSample next();
+    EcosystemRegime regime() const { return regime_; }
+
+private:
+    void advanceRegime();
+
+    SyntheticRng rng_;
+    EcosystemRegime regime_;
+
+    // Site traits, fixed per plot
+    float potential_;   // Health the site settles at when undisturbed
+    float resilience_;  // Scales recovery speed
+    float noise_;       // Observation noise
+
+    // Latent state
+    float health_;
+    float soil_;
+    float vegetation_;
+    float vigorLag_;
+};
+
+// "PLOT-000042"
+std::string syntheticPlotId(size_t plotIndex);
@@ -0,0 +1,56 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ==========================================
+// Work-stealing worker pool
+// ==========================================
+// Every worker owns a task deque. Workers pop their own deque from the back
+// and, when it runs dry, steal from the front of the others, so uneven tasks
+// (e.g. trajectories of very different lengths) balance without a shared queue.
+
+class ThreadPool {
+public:
+    // threadCount == 0 uses std::thread::hardware_concurrency()
+    explicit ThreadPool(size_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const;
+
+    // Tasks submitted from a worker go to its own deque, others are spread round-robin
+    void submit(std::function<void()> task);
+
+    // Runs fn(shard) for every shard in [0, shards) and blocks until all finish.
+    // The first exception thrown by a shard is rethrown to the caller. The caller
+    // runs queued tasks while it waits, so it may be called from a worker.
+    void parallelFor(size_t shards, const std::function<void(size_t)>& fn);
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void workerLoop(size_t index);
+    bool popLocal(size_t index, std::function<void()>& task);
+    bool steal(size_t thief, std::function<void()>& task);
+    bool takeTask(std::function<void()>& task);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<size_t> pending_{0};
+    std::atomic<size_t> nextQueue_{0};
+    std::mutex sleepMutex_;
+    std::condition_variable sleepCv_;
+    bool stopping_ = false;
+};
@@ -1,12 +1,34 @@
 import json
 import matplotlib.pyplot as plt
 import os
+import struct
 import sys
 
+def load_results(path):
+    """Reads NDJSON or binary (.ecores) results; legacy {"history": [...]} JSON is still accepted."""
+    if path.endswith(".ecores"):
+        with open(path, 'rb') as f:
+            blob = f.read()
+        _, version, record_size, count, _, _ = struct.unpack_from("<8sIIQQI", blob, 0)
+        # Version 1 stored 32-bit steps after the plot index
+        record = "<QIfff" if version >= 2 else "<IIfff"
+        rows = []
+        for i in range(count):
+            fields = struct.unpack_from(record, blob, 64 + i * record_size)
+            step = fields[0] if version >= 2 else fields[1]
+            integrity, recovery, resilience = fields[2:]
+            rows.append({"step": step, "functional_integrity": integrity,
+                         "recovery_capacity": recovery, "resilience_potential": resilience})
+        return rows
+
+    with open(path, 'r') as f:
+        if path.endswith(".json"):
+            return json.load(f)["history"]
+        return [json.loads(line) for line in f if line.strip()]
+
 def plot_results(json_path):
     try:
-        with open(json_path, 'r') as f:
-            data = json.load(f)["history"]
+        data = load_results(json_path)
     except FileNotFoundError:
         print(f"Error: {json_path} not found. Run the C++ app first.")
         return
@@ -43,7 +65,7 @@ def plot_results(json_path):
     print(f"Plot saved to {output_file}")
 
 if __name__ == "__main__":
-    json_file = os.path.join("outputs", "inference_results.json")
+    json_file = os.path.join("outputs", "inference_results.ndjson")
     if len(sys.argv) > 1:
         json_file = sys.argv[1]
     plot_results(json_file)
@@ -0,0 +1,382 @@
+#include "columnar_dataset.h"
+#include "csv_reader.h"
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+uint64_t alignUp(uint64_t value) {
+    return (value + COLUMNAR_ALIGNMENT - 1) / COLUMNAR_ALIGNMENT * COLUMNAR_ALIGNMENT;
+}
+
+void writePadding(std::ofstream& out, uint64_t& position, uint64_t target) {
+    static const char zeros[COLUMNAR_ALIGNMENT] = {};
+    while (position < target) {
+        uint64_t n = std::min<uint64_t>(target - position, COLUMNAR_ALIGNMENT);
+        out.write(zeros, static_cast<std::streamsize>(n));
+        position += n;
+    }
+}
+
+template <typename T>
+void writeColumn(std::ofstream& out, uint64_t& position, const std::vector<T>& values) {
+    out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+    position += values.size() * sizeof(T);
+    writePadding(out, position, alignUp(position));
+}
+
+// Header with the column blocks laid out for 'rows' rows and the columns in 'flags'
+ColumnarHeader layoutColumnarHeader(uint64_t rows, uint32_t flags, const std::vector<std::string>& plotIds) {
+    ColumnarHeader header{};
+    std::memcpy(header.magic, COLUMNAR_MAGIC, sizeof(header.magic));
+    header.version = COLUMNAR_VERSION;
+    header.flags = flags;
+    header.rowCount = rows;
+    header.attributeCount = ECOVECTOR_SIZE;
+    header.plotCount = static_cast<uint32_t>(plotIds.size());
+
+    uint64_t offset = sizeof(ColumnarHeader);
+    for (size_t i = 0; i < ECOVECTOR_SIZE; ++i) {
+        header.attributeOffsets[i] = offset;
+        offset = alignUp(offset + rows * sizeof(float));
+    }
+    if (flags & COLUMNAR_HAS_TARGET) {
+        header.targetOffset = offset;
+        offset = alignUp(offset + rows * sizeof(float));
+    }
+    if (flags & COLUMNAR_HAS_PLOT_ID) {
+        header.plotIndexOffset = offset;
+        offset = alignUp(offset + rows * sizeof(uint32_t));
+    }
+    if (flags & COLUMNAR_HAS_TIMESTAMP) {
+        header.timestampOffset = offset;
+        offset = alignUp(offset + rows * sizeof(int64_t));
+    }
+    header.plotTableOffset = offset;
+    for (const auto& id : plotIds) header.plotTableSize += sizeof(uint32_t) + id.size();
+    return header;
+}
+
+void writePlotTable(std::ostream& out, const std::vector<std::string>& plotIds) {
+    for (const auto& id : plotIds) {
+        uint32_t length = static_cast<uint32_t>(id.size());
+        out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        out.write(id.data(), static_cast<std::streamsize>(id.size()));
+    }
+}
+
+bool parseInt64(std::string_view field, int64_t& out) {
+    while (!field.empty() && field.front() == ' ') field.remove_prefix(1);
+    auto result = std::from_chars(field.data(), field.data() + field.size(), out);
+    return result.ec == std::errc() && result.ptr != field.data();
+}
+
+} // namespace
+
+// ==========================================
+// Writer
+// ==========================================
+
+void writeColumnarFile(const std::string& path, const ColumnarTable& table) {
+    const uint64_t rows = table.rowCount();
+    for (const auto& column : table.attributes) {
+        if (column.size() != rows) throw std::invalid_argument("Columnar attribute columns differ in length");
+    }
+    if (!table.target.empty() && table.target.size() != rows) throw std::invalid_argument("Columnar target column length mismatch");
+    if (!table.plotIndex.empty() && table.plotIndex.size() != rows) throw std::invalid_argument("Columnar plot column length mismatch");
+    if (!table.timestamps.empty() && table.timestamps.size() != rows) throw std::invalid_argument("Columnar timestamp column length mismatch");
+
+    uint32_t flags = 0;
+    if (!table.target.empty()) flags |= COLUMNAR_HAS_TARGET;
+    if (!table.plotIndex.empty()) flags |= COLUMNAR_HAS_PLOT_ID;
+    if (!table.timestamps.empty()) flags |= COLUMNAR_HAS_TIMESTAMP;
+    const ColumnarHeader header = layoutColumnarHeader(rows, flags, table.plotIds);
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) {
+        throw std::runtime_error("Cannot write columnar file: " + path);
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    uint64_t position = sizeof(header);
+
+    for (const auto& column : table.attributes) writeColumn(out, position, column);
+    if (!table.target.empty()) writeColumn(out, position, table.target);
+    if (!table.plotIndex.empty()) writeColumn(out, position, table.plotIndex);
+    if (!table.timestamps.empty()) writeColumn(out, position, table.timestamps);
+
+    writePlotTable(out, table.plotIds);
+    if (!out) {
+        throw std::runtime_error("Failed writing columnar file: " + path);
+    }
+}
+
+// ==========================================
+// Streaming writer
+// ==========================================
+
+ColumnarStreamWriter::ColumnarStreamWriter(const std::string& path, uint64_t rowCount, uint32_t flags,
+                                           std::vector<std::string> plotIds)
+    : header_(layoutColumnarHeader(rowCount, flags, plotIds)),
+      plotIds_(std::move(plotIds)),
+      out_(path, std::ios::binary),
+      path_(path) {
+    if (!out_.is_open()) {
+        throw std::runtime_error("Cannot write columnar file: " + path);
+    }
+    out_.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+    for (auto& column : attributes_) column.reserve(COLUMNAR_STREAM_CHUNK_ROWS);
+}
+
+ColumnarStreamWriter::~ColumnarStreamWriter() {
+    try {
+        close();
+    } catch (...) {
+        // Destructors must not throw; call close() explicitly to observe errors
+    }
+}
+
+void ColumnarStreamWriter::append(const std::array<float, ECOVECTOR_SIZE>& attributes, float target,
+                                  uint32_t plotIndex, int64_t timestamp) {
+    if (closed_ || written_ + attributes_[0].size() >= header_.rowCount) {
+        throw std::logic_error("More rows than declared for columnar file: " + path_);
+    }
+    for (size_t c = 0; c < ECOVECTOR_SIZE; ++c) attributes_[c].push_back(attributes[c]);
+    if (header_.flags & COLUMNAR_HAS_TARGET) target_.push_back(target);
+    if (header_.flags & COLUMNAR_HAS_PLOT_ID) plotIndex_.push_back(plotIndex);
+    if (header_.flags & COLUMNAR_HAS_TIMESTAMP) timestamps_.push_back(timestamp);
+    if (attributes_[0].size() == COLUMNAR_STREAM_CHUNK_ROWS) flushChunk();
+}
+
+template <typename T>
+void ColumnarStreamWriter::writeChunk(uint64_t columnOffset, std::vector<T>& values) {
+    out_.seekp(static_cast<std::streamoff>(columnOffset + written_ * sizeof(T)));
+    out_.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+    values.clear();
+}
+
+void ColumnarStreamWriter::flushChunk() {
+    const size_t rows = attributes_[0].size();
+    if (rows == 0) return;
+    for (size_t c = 0; c < ECOVECTOR_SIZE; ++c) writeChunk(header_.attributeOffsets[c], attributes_[c]);
+    if (header_.flags & COLUMNAR_HAS_TARGET) writeChunk(header_.targetOffset, target_);
+    if (header_.flags & COLUMNAR_HAS_PLOT_ID) writeChunk(header_.plotIndexOffset, plotIndex_);
+    if (header_.flags & COLUMNAR_HAS_TIMESTAMP) writeChunk(header_.timestampOffset, timestamps_);
+    written_ += rows;
+    if (!out_) {
+        throw std::runtime_error("Failed writing columnar file: " + path_);
+    }
+}
+
+void ColumnarStreamWriter::close() {
+    if (closed_) return;
+    closed_ = true;
+    flushChunk();
+    if (written_ != header_.rowCount) {
+        throw std::runtime_error("Columnar file " + path_ + " got " + std::to_string(written_) + " of " +
+                                 std::to_string(header_.rowCount) + " declared rows");
+    }
+    // Earlier column gaps were skipped by seeking and read back as zeros; the
+    // last column's padding and the plot table complete the file
+    uint64_t lastColumnEnd = header_.attributeOffsets[ECOVECTOR_SIZE - 1] + written_ * sizeof(float);
+    if (header_.flags & COLUMNAR_HAS_TARGET) lastColumnEnd = header_.targetOffset + written_ * sizeof(float);
+    if (header_.flags & COLUMNAR_HAS_PLOT_ID) lastColumnEnd = header_.plotIndexOffset + written_ * sizeof(uint32_t);
+    if (header_.flags & COLUMNAR_HAS_TIMESTAMP) lastColumnEnd = header_.timestampOffset + written_ * sizeof(int64_t);
+    out_.seekp(static_cast<std::streamoff>(lastColumnEnd));
+    writePadding(out_, lastColumnEnd, header_.plotTableOffset);
+    writePlotTable(out_, plotIds_);
+    out_.close();
+    if (!out_) {
+        throw std::runtime_error("Failed writing columnar file: " + path_);
+    }
+}
+
+ColumnarTable columnarTableFromCSV(const std::string& csvPath) {
+    MappedFile file;
+    if (!file.open(csvPath)) {
+        throw std::runtime_error("Cannot open CSV: " + csvPath);
+    }
+
+    CsvLineReader lines(file.view());
+    std::string_view line;
+    if (!lines.next(line)) {
+        throw std::runtime_error("CSV has no header: " + csvPath);
+    }
+
+    // Map header columns to roles
+    constexpr int NONE = -1;
+    int plotColumn = NONE;
+    int timestampColumn = NONE;
+    size_t numericColumns = 0;
+    {
+        CsvFieldReader fields(line);
+        std::string_view name;
+        for (int c = 0; fields.next(name); ++c) {
+            while (!name.empty() && (name.back() == ' ' || name.back() == '\r')) name.remove_suffix(1);
+            if (name == "PlotId") plotColumn = c;
+            else if (name == "Timestamp") timestampColumn = c;
+            else numericColumns++;
+        }
+    }
+    if (numericColumns < ECOVECTOR_SIZE) {
+        throw std::runtime_error("CSV header has fewer than 10 attribute columns: " + csvPath);
+    }
+    const bool hasTarget = numericColumns > ECOVECTOR_SIZE;
+
+    ColumnarTable table;
+    std::unordered_map<std::string, uint32_t> plotIndex;
+    std::string plotKey;
+    std::vector<CsvDiagnostic> diagnostics;
+
+    while (lines.next(line)) {
+        if (line.empty()) continue;
+        CsvFieldReader fields(line);
+        std::string_view field;
+        std::array<float, ECOVECTOR_SIZE + 1> values;
+        std::string_view plotField;
+        int64_t timestamp = 0;
+        size_t count = 0;
+        bool valid = true;
+
+        for (int c = 0; fields.next(field); ++c) {
+            if (c == plotColumn) {
+                plotField = field;
+            } else if (c == timestampColumn) {
+                if (!parseInt64(field, timestamp)) {
+                    diagnostics.push_back({lines.lineNumber(), "Skipping line with invalid timestamp '" + std::string(field) + "'"});
+                    valid = false;
+                }
+            } else {
+                float value;
+                if (parseFloat(field, value)) {
+                    if (count < values.size()) values[count] = value;
+                    count++;
+                } else {
+                    diagnostics.push_back({lines.lineNumber(), "Skipping invalid value '" + std::string(field) + "'"});
+                }
+            }
+        }
+
+        const size_t required = hasTarget ? ECOVECTOR_SIZE + 1 : ECOVECTOR_SIZE;
+        if (plotColumn != NONE && plotField.empty()) {
+            diagnostics.push_back({lines.lineNumber(), "Skipping line without plot id"});
+            valid = false;
+        }
+        if (count < required) {
+            diagnostics.push_back({lines.lineNumber(), "Skipping line with insufficient columns: " + std::to_string(count)});
+            valid = false;
+        }
+        if (!valid) continue;
+
+        for (size_t i = 0; i < ECOVECTOR_SIZE; ++i) table.attributes[i].push_back(values[i]);
+        if (hasTarget) table.target.push_back(values[ECOVECTOR_SIZE]);
+        if (timestampColumn != NONE) table.timestamps.push_back(timestamp);
+        if (plotColumn != NONE) {
+            plotKey.assign(plotField.data(), plotField.size());
+            auto inserted = plotIndex.emplace(plotKey, static_cast<uint32_t>(table.plotIds.size()));
+            if (inserted.second) table.plotIds.push_back(plotKey);
+            table.plotIndex.push_back(inserted.first->second);
+        }
+    }
+
+    reportDiagnostics(diagnostics, "[Columnar]");
+    return table;
+}
+
+// ==========================================
+// Reader
+// ==========================================
+
+void ColumnarDataset::open(const std::string& path) {
+    header_ = nullptr;
+    plotIds_.clear();
+    if (!file_.open(path)) {
+        throw std::runtime_error("Cannot open columnar file: " + path);
+    }
+    if (file_.size() < sizeof(ColumnarHeader)) {
+        throw std::runtime_error("Columnar file too small: " + path);
+    }
+
+    const auto* header = reinterpret_cast<const ColumnarHeader*>(file_.data());
+    if (std::memcmp(header->magic, COLUMNAR_MAGIC, sizeof(header->magic)) != 0) {
+        throw std::runtime_error("Not a columnar dataset file: " + path);
+    }
+    if (header->version != COLUMNAR_VERSION) {
+        throw std::runtime_error("Unsupported columnar file version " + std::to_string(header->version) + ": " + path);
+    }
+    if (header->attributeCount != ECOVECTOR_SIZE) {
+        throw std::runtime_error("Columnar file has unexpected attribute count: " + path);
+    }
+
+    // Every column must lie inside the mapping and be aligned
+    auto checkColumn = [&](uint64_t offset, size_t elementSize) {
+        if (offset % COLUMNAR_ALIGNMENT != 0 || offset > file_.size() ||
+            header->rowCount > (file_.size() - offset) / elementSize) {
+            throw std::runtime_error("Columnar file is truncated or corrupt: " + path);
+        }
+    };
+    for (size_t i = 0; i < ECOVECTOR_SIZE; ++i) checkColumn(header->attributeOffsets[i], sizeof(float));
+    if (header->flags & COLUMNAR_HAS_TARGET) checkColumn(header->targetOffset, sizeof(float));
+    if (header->flags & COLUMNAR_HAS_PLOT_ID) checkColumn(header->plotIndexOffset, sizeof(uint32_t));
+    if (header->flags & COLUMNAR_HAS_TIMESTAMP) checkColumn(header->timestampOffset, sizeof(int64_t));
+
+    if (header->plotTableOffset > file_.size() || header->plotTableSize > file_.size() - header->plotTableOffset) {
+        throw std::runtime_error("Columnar plot table is truncated: " + path);
+    }
+    const char* cursor = file_.data() + header->plotTableOffset;
+    const char* end = cursor + header->plotTableSize;
+    plotIds_.reserve(header->plotCount);
+    for (uint32_t p = 0; p < header->plotCount; ++p) {
+        uint32_t length;
+        if (end - cursor < static_cast<std::ptrdiff_t>(sizeof(length))) {
+            throw std::runtime_error("Columnar plot table is corrupt: " + path);
+        }
+        std::memcpy(&length, cursor, sizeof(length));
+        cursor += sizeof(length);
+        if (end - cursor < static_cast<std::ptrdiff_t>(length)) {
+            throw std::runtime_error("Columnar plot table is corrupt: " + path);
+        }
+        plotIds_.emplace_back(cursor, length);
+        cursor += length;
+    }
+    if (header->flags & COLUMNAR_HAS_PLOT_ID) {
+        const uint32_t* index = reinterpret_cast<const uint32_t*>(file_.data() + header->plotIndexOffset);
+        for (uint64_t r = 0; r < header->rowCount; ++r) {
+            if (index[r] >= header->plotCount) {
+                throw std::runtime_error("Columnar plot index out of range: " + path);
+            }
+        }
+    }
+
+    header_ = header;
+}
+
+template <typename T>
+const T* ColumnarDataset::column(uint64_t offset) const {
+    return reinterpret_cast<const T*>(file_.data() + offset);
+}
+
+const float* ColumnarDataset::attribute(size_t index) const {
+    return column<float>(header_->attributeOffsets[index]);
+}
+
+const float* ColumnarDataset::target() const {
+    return hasTarget() ? column<float>(header_->targetOffset) : nullptr;
+}
+
+const uint32_t* ColumnarDataset::plotIndex() const {
+    return hasPlotId() ? column<uint32_t>(header_->plotIndexOffset) : nullptr;
+}
+
+const int64_t* ColumnarDataset::timestamps() const {
+    return hasTimestamp() ? column<int64_t>(header_->timestampOffset) : nullptr;
+}
+
+bool isColumnarPath(const std::string& path) {
+    const std::string extension = ".ecol";
+    return path.size() >= extension.size() &&
+           path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+}
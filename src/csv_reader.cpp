@@ -0,0 +1,102 @@
+#include "csv_reader.h"
+#include "logging.h"
+#include <algorithm>
+#include <charconv>
+
+// ==========================================
+// CsvLineReader / CsvFieldReader
+// ==========================================
+
+CsvLineReader::CsvLineReader(std::string_view buffer, size_t firstLineNumber)
+    : buffer_(buffer), lineNumber_(firstLineNumber - 1) {}
+
+bool CsvLineReader::next(std::string_view& line) {
+    if (pos_ >= buffer_.size()) return false;
+
+    size_t end = buffer_.find('\n', pos_);
+    if (end == std::string_view::npos) end = buffer_.size();
+
+    line = buffer_.substr(pos_, end - pos_);
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+    pos_ = end + 1;
+    lineNumber_++;
+    return true;
+}
+
+bool CsvFieldReader::next(std::string_view& field) {
+    if (pos_ >= line_.size()) return false;
+
+    size_t end = line_.find(',', pos_);
+    if (end == std::string_view::npos) end = line_.size();
+
+    field = line_.substr(pos_, end - pos_);
+    pos_ = end + 1;
+    return true;
+}
+
+// ==========================================
+// Float parsing
+// ==========================================
+
+bool parseFloat(std::string_view field, float& out) {
+    const char* first = field.data();
+    const char* last = field.data() + field.size();
+
+    while (first != last && (*first == ' ' || *first == '\t' || *first == '\r' || *first == '\n'))
+        ++first;
+    // std::stof accepts one sign; from_chars only '-', so '+' is skipped here
+    if (first != last && *first == '+') {
+        ++first;
+        if (first != last && *first == '-') return false;
+    }
+
+    auto result = std::from_chars(first, last, out);
+    return result.ec == std::errc() && result.ptr != first;
+}
+
+size_t parseFloatFields(CsvFieldReader& fields, float* out, size_t capacity,
+                        std::vector<CsvDiagnostic>& diagnostics, size_t lineNumber) {
+    size_t count = 0;
+    std::string_view field;
+    while (fields.next(field)) {
+        float value;
+        if (parseFloat(field, value)) {
+            if (count < capacity) out[count] = value;
+            count++;
+        } else {
+            diagnostics.push_back({lineNumber, "Skipping invalid value '" + std::string(field) + "'"});
+        }
+    }
+    return count;
+}
+
+void reportDiagnostics(const std::vector<CsvDiagnostic>& diagnostics, const char* tag) {
+    for (const auto& diagnostic : diagnostics) {
+        ECO_LOG_WARN(tag << " " << diagnostic.message << " (line " << diagnostic.line << ")");
+    }
+}
+
+// ==========================================
+// Chunking
+// ==========================================
+
+std::vector<std::string_view> splitCsvChunks(std::string_view buffer, size_t maxChunks,
+                                             size_t minChunkBytes) {
+    std::vector<std::string_view> chunks;
+    if (buffer.empty()) return chunks;
+
+    size_t chunkCount = std::max<size_t>(1, std::min(maxChunks, buffer.size() / std::max<size_t>(1, minChunkBytes)));
+    size_t start = 0;
+    for (size_t c = 1; c <= chunkCount && start < buffer.size(); ++c) {
+        size_t end = buffer.size();
+        if (c < chunkCount) {
+            size_t target = std::max(start, buffer.size() / chunkCount * c);
+            size_t newline = buffer.find('\n', target);
+            end = (newline == std::string_view::npos) ? buffer.size() : newline + 1;
+        }
+        chunks.push_back(buffer.substr(start, end - start));
+        start = end;
+    }
+    return chunks;
+}
@@ -1,85 +1,274 @@
 #include "data_loader.h"
-#include <fstream>
-#include <sstream>
-#include <iostream>
+#include "csv_reader.h"
+#include "columnar_dataset.h"
+#include "thread_pool.h"
+#include "instrumentation.h"
+#include "logging.h"
 #include <stdexcept>
+#include <unordered_map>
 
-EcofunctionalExperiment DataLoader::loadExperimentFromCSV(const std::string& filepath, const std::string& experimentId) {
+namespace {
+
+template <typename Row>
+struct ParsedChunk {
+    std::vector<Row> rows;
+    std::vector<CsvDiagnostic> diagnostics; // Line numbers local to the chunk until merged
+    size_t lineCount = 0;
+};
+
+// Parses the data section of a CSV (everything after the header) in
+// newline-aligned chunks, on 'threads' workers when there is enough input.
+// parseLine(line, lineNumber, rows, diagnostics) handles one non-empty line.
+// Rows come back in file order and diagnostics carry global line numbers.
+template <typename Row, typename ParseLine>
+std::vector<Row> parseChunked(const MappedFile& file, size_t threads, const char* tag, ParseLine parseLine) {
+    CsvLineReader headerReader(file.view());
+    std::string_view header;
+    headerReader.next(header); // Skip Header
+    const size_t firstLine = headerReader.lineNumber() + 1;
+    std::string_view body = file.view().substr(headerReader.offset());
+
+    if (threads == 0) threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    auto ranges = splitCsvChunks(body, threads);
+    std::vector<ParsedChunk<Row>> chunks(ranges.size());
+
+    auto parseRange = [&](size_t c) {
+        ParsedChunk<Row>& chunk = chunks[c];
+        CsvLineReader lines(ranges[c]);
+        std::string_view line;
+        while (lines.next(line)) {
+            if (line.empty()) continue;
+            parseLine(line, lines.lineNumber(), chunk.rows, chunk.diagnostics);
+        }
+        chunk.lineCount = lines.lineNumber();
+    };
+
+    if (ranges.size() > 1) {
+        ThreadPool pool(std::min(threads, ranges.size()));
+        pool.parallelFor(ranges.size(), parseRange);
+    } else if (!ranges.empty()) {
+        parseRange(0);
+    }
+
+    // Merge in chunk order, shifting local line numbers to file line numbers
+    size_t total = 0;
+    for (const auto& chunk : chunks) total += chunk.rows.size();
+    std::vector<Row> rows;
+    rows.reserve(total);
+
+    size_t lineOffset = firstLine - 1;
+    for (auto& chunk : chunks) {
+        for (auto& diagnostic : chunk.diagnostics) diagnostic.line += lineOffset;
+        reportDiagnostics(chunk.diagnostics, tag);
+        lineOffset += chunk.lineCount;
+        rows.insert(rows.end(), std::make_move_iterator(chunk.rows.begin()),
+                    std::make_move_iterator(chunk.rows.end()));
+    }
+    return rows;
+}
+
+std::string insufficientColumns(size_t count) {
+    return "Skipping line with insufficient columns: " + std::to_string(count);
+}
+
+EcofunctionalVector rowFromColumns(const ColumnarDataset& data, size_t row) {
+    std::array<float, ECOVECTOR_SIZE> values;
+    for (size_t i = 0; i < ECOVECTOR_SIZE; ++i) values[i] = data.attribute(i)[row];
+    return EcofunctionalVector::fromArray(values);
+}
+
+struct FleetRow {
+    std::string_view plotId; // Points into the mapped file
+    EcofunctionalVector vector;
+};
+
+} // namespace
+
+EcofunctionalExperiment DataLoader::loadExperimentFromCSV(const std::string& filepath, const std::string& experimentId,
+                                                          size_t threads) {
+    ECO_TIME_SCOPE("load.experiment");
     EcofunctionalExperiment experiment(experimentId);
     
     // Reusing the simple loadCSV from dataset.cpp would require adaptation since columns might differ.
     // Implementing a specific parser here for the Domain CSV format.
     
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
+    MappedFile file;
+    if (!file.open(filepath)) {
         throw std::runtime_error("Cannot open training CSV: " + filepath);
     }
-    std::string line;
-    
-    // Skip Header
-    if (file.good()) std::getline(file, line);
-
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
-        std::stringstream ss(line);
-        std::string val;
-        std::vector<float> row;
-        
-        // CSV Format: SoildDepth, SoilComp, ..., Propagule, FunctionalIntegrity
-        while (std::getline(ss, val, ',')) {
-            try {
-                row.push_back(std::stof(val));
-            } catch (const std::exception&) {
-                std::cerr << "[DataLoader] Skipping invalid value '" << val << "'\n";
+
+    auto samples = parseChunked<EcofunctionalSample>(file, threads, "[DataLoader]",
+        [](std::string_view line, size_t lineNumber, std::vector<EcofunctionalSample>& rows,
+           std::vector<CsvDiagnostic>& diagnostics) {
+            CsvFieldReader fields(line);
+            std::array<float, 11> row;
+
+            // CSV Format: SoildDepth, SoilComp, ..., Propagule, FunctionalIntegrity
+            size_t count = parseFloatFields(fields, row.data(), row.size(), diagnostics, lineNumber);
+
+            if (count >= 11) { // 10 features + 1 target
+                EcofunctionalVector vec = EcofunctionalVector::fromArray({row[0], row[1], row[2], row[3], row[4],
+                                                                          row[5], row[6], row[7], row[8], row[9]});
+                float target = row[10];
+                rows.push_back({vec, target});
+            } else {
+                diagnostics.push_back({lineNumber, insufficientColumns(count)});
             }
-        }
+        });
 
-        if (row.size() >= 11) { // 10 features + 1 target
-            EcofunctionalVector vec = EcofunctionalVector::fromVector({row.begin(), row.begin() + 10});
-            float target = row[10];
-            experiment.addSample({vec, target});
-        } else {
-            std::cerr << "[DataLoader] Skipping line with insufficient columns: " << row.size() << std::endl;
-        }
+    experiment.mutableSamples().reserve(samples.size());
+    for (const auto& sample : samples) {
+        experiment.addSample(sample);
     }
 
-    std::cout << "[DataLoader] Loaded " << experiment.getSamples().size() << " samples for experiment " << experimentId << std::endl;
+    ECO_COUNT("load.rows", experiment.getSamples().size());
+    ECO_LOG_INFO("[DataLoader] Loaded " << experiment.getSamples().size() << " samples for experiment " << experimentId);
     return experiment;
 }
 
-EcofunctionalTrajectory DataLoader::loadTrajectoryFromCSV(const std::string& filepath) {
+EcofunctionalTrajectory DataLoader::loadTrajectoryFromCSV(const std::string& filepath, size_t threads) {
+    ECO_TIME_SCOPE("load.trajectory");
     EcofunctionalTrajectory traj;
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
+    MappedFile file;
+    if (!file.open(filepath)) {
         throw std::runtime_error("Cannot open trajectory CSV: " + filepath);
     }
-    std::string line;
-    
-    // Skip Header
-    if (file.good()) std::getline(file, line);
-
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
-        std::stringstream ss(line);
-        std::string val;
-        std::vector<float> row;
-        
-        while (std::getline(ss, val, ',')) {
-             try {
-                row.push_back(std::stof(val));
-            } catch (const std::exception&) { 
-                std::cerr << "[DataLoader] Skipping invalid value '" << val << "'\n";
+
+    auto samples = parseChunked<EcofunctionalSample>(file, threads, "[DataLoader]",
+        [](std::string_view line, size_t lineNumber, std::vector<EcofunctionalSample>& rows,
+           std::vector<CsvDiagnostic>& diagnostics) {
+            CsvFieldReader fields(line);
+            std::array<float, ECOVECTOR_SIZE> row;
+
+            size_t count = parseFloatFields(fields, row.data(), row.size(), diagnostics, lineNumber);
+
+            if (count >= 10) {
+                // For inference, we might not have target, use 0.0 default
+                rows.push_back({EcofunctionalVector::fromArray(row), 0.0f});
+            } else {
+                diagnostics.push_back({lineNumber, insufficientColumns(count)});
             }
-        }
+        });
 
-        if (row.size() >= 10) { 
-            // For inference, we might not have target, use 0.0 default
-            EcofunctionalVector vec = EcofunctionalVector::fromVector({row.begin(), row.begin() + 10});
-            traj.addSample({vec, 0.0f});
-        } else {
-            std::cerr << "[DataLoader] Skipping line with insufficient columns: " << row.size() << std::endl;
+    // The streaming feature state is sequential by nature, so samples are appended in order here
+    traj.history.reserve(samples.size());
+    for (const auto& sample : samples) {
+        traj.addSample(sample);
+    }
+    ECO_COUNT("load.rows", traj.history.size());
+    ECO_LOG_INFO("[DataLoader] Loaded trajectory with " << traj.history.size() << " steps.");
+    return traj;
+}
+
+std::vector<PlotTrajectory> DataLoader::loadFleetFromCSV(const std::string& filepath, size_t threads) {
+    ECO_TIME_SCOPE("load.fleet");
+    std::vector<PlotTrajectory> plots;
+    std::unordered_map<std::string, size_t> plotIndex;
+    MappedFile file;
+    if (!file.open(filepath)) {
+        throw std::runtime_error("Cannot open fleet CSV: " + filepath);
+    }
+
+    auto rows = parseChunked<FleetRow>(file, threads, "[DataLoader]",
+        [](std::string_view line, size_t lineNumber, std::vector<FleetRow>& out,
+           std::vector<CsvDiagnostic>& diagnostics) {
+            CsvFieldReader fields(line);
+            std::string_view plotField;
+            std::array<float, ECOVECTOR_SIZE> row;
+
+            if (!fields.next(plotField) || plotField.empty()) {
+                diagnostics.push_back({lineNumber, "Skipping line without plot id"});
+                return;
+            }
+            size_t count = parseFloatFields(fields, row.data(), row.size(), diagnostics, lineNumber);
+
+            if (count >= 10) {
+                out.push_back({plotField, EcofunctionalVector::fromArray(row)});
+            } else {
+                diagnostics.push_back({lineNumber, insufficientColumns(count)});
+            }
+        });
+
+    std::string plotId; // Reused key buffer, avoids a fresh string per row
+    for (const auto& row : rows) {
+        plotId.assign(row.plotId.data(), row.plotId.size());
+        auto inserted = plotIndex.emplace(plotId, plots.size());
+        if (inserted.second) {
+            plots.push_back({plotId, EcofunctionalTrajectory{}});
         }
+        plots[inserted.first->second].trajectory.addSample({row.vector, 0.0f});
     }
-    std::cout << "[DataLoader] Loaded trajectory with " << traj.history.size() << " steps." << std::endl;
+    ECO_COUNT("load.rows", rows.size());
+    ECO_LOG_INFO("[DataLoader] Loaded fleet with " << plots.size() << " plots and " << rows.size() << " steps.");
+    return plots;
+}
+
+EcofunctionalExperiment DataLoader::loadExperimentFromColumnar(const std::string& filepath, const std::string& experimentId) {
+    ECO_TIME_SCOPE("load.experiment");
+    EcofunctionalExperiment experiment(experimentId);
+    ColumnarDataset data;
+    data.open(filepath);
+    if (!data.hasTarget()) {
+        throw std::runtime_error("Columnar training file has no target column: " + filepath);
+    }
+
+    // Column to column copy into the SoA sample store
+    std::array<const float*, ECOVECTOR_SIZE> attributes;
+    for (size_t i = 0; i < ECOVECTOR_SIZE; ++i) attributes[i] = data.attribute(i);
+    experiment.mutableSamples().appendColumns(attributes, data.target(), data.rowCount());
+    ECO_COUNT("load.rows", experiment.getSamples().size());
+    ECO_LOG_INFO("[DataLoader] Loaded " << experiment.getSamples().size() << " samples for experiment " << experimentId);
+    return experiment;
+}
+
+EcofunctionalTrajectory DataLoader::loadTrajectoryFromColumnar(const std::string& filepath) {
+    ECO_TIME_SCOPE("load.trajectory");
+    EcofunctionalTrajectory traj;
+    ColumnarDataset data;
+    data.open(filepath);
+
+    traj.history.reserve(data.rowCount());
+    for (size_t r = 0; r < data.rowCount(); ++r) {
+        traj.addSample({rowFromColumns(data, r), 0.0f});
+    }
+    ECO_COUNT("load.rows", traj.history.size());
+    ECO_LOG_INFO("[DataLoader] Loaded trajectory with " << traj.history.size() << " steps.");
     return traj;
 }
+
+std::vector<PlotTrajectory> DataLoader::loadFleetFromColumnar(const std::string& filepath) {
+    ECO_TIME_SCOPE("load.fleet");
+    ColumnarDataset data;
+    data.open(filepath);
+    if (!data.hasPlotId()) {
+        throw std::runtime_error("Columnar fleet file has no plot id column: " + filepath);
+    }
+
+    // Plot ids are already interned in the file, so plots map 1:1 onto the table
+    std::vector<PlotTrajectory> plots(data.plotIds().size());
+    for (size_t p = 0; p < plots.size(); ++p) plots[p].plotId = data.plotIds()[p];
+
+    const uint32_t* plotIndex = data.plotIndex();
+    for (size_t r = 0; r < data.rowCount(); ++r) {
+        plots[plotIndex[r]].trajectory.addSample({rowFromColumns(data, r), 0.0f});
+    }
+    ECO_COUNT("load.rows", data.rowCount());
+    ECO_LOG_INFO("[DataLoader] Loaded fleet with " << plots.size() << " plots and " << data.rowCount() << " steps.");
+    return plots;
+}
+
+EcofunctionalExperiment DataLoader::loadExperiment(const std::string& filepath, const std::string& experimentId,
+                                                   size_t threads) {
+    return isColumnarPath(filepath) ? loadExperimentFromColumnar(filepath, experimentId)
+                                    : loadExperimentFromCSV(filepath, experimentId, threads);
+}
+
+EcofunctionalTrajectory DataLoader::loadTrajectory(const std::string& filepath, size_t threads) {
+    return isColumnarPath(filepath) ? loadTrajectoryFromColumnar(filepath)
+                                    : loadTrajectoryFromCSV(filepath, threads);
+}
+
+std::vector<PlotTrajectory> DataLoader::loadFleet(const std::string& filepath, size_t threads) {
+    return isColumnarPath(filepath) ? loadFleetFromColumnar(filepath)
+                                    : loadFleetFromCSV(filepath, threads);
+}
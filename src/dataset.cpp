@@ -1,46 +1,47 @@
 #include "dataset.h"
-#include <fstream>
-#include <sstream>
-#include <iostream>
+#include "csv_reader.h"
+#include "logging.h"
 #include <stdexcept>
 
 Dataset loadCSV(const std::string& path) {
     Dataset ds;
-    std::ifstream file(path);
-    if (!file.is_open()) {
+    MappedFile file;
+    if (!file.open(path)) {
         throw std::runtime_error("Failed to open CSV: " + path);
     }
 
-    std::string line;
+    CsvLineReader lines(file.view());
+    std::string_view line;
     bool skippedHeader = false;
+    std::vector<float> row; // Reused across lines; only the final copy into ds.X allocates
 
-    while (std::getline(file, line)) {
+    while (lines.next(line)) {
         if (!skippedHeader) { // assume first line is header
             skippedHeader = true;
             continue;
         }
         if (line.empty()) continue;
 
-        std::stringstream ss(line);
-        std::vector<float> row;
-        std::string value;
+        row.clear();
+        CsvFieldReader fields(line);
+        std::string_view value;
 
-        while (std::getline(ss, value, ',')) {
-            try {
-                row.push_back(std::stof(value));
-            } catch (const std::exception& e) {
-                std::cerr << "[loadCSV] Skipping invalid value '" << value << "'\n";
+        while (fields.next(value)) {
+            float parsed;
+            if (parseFloat(value, parsed)) {
+                row.push_back(parsed);
+            } else {
+                ECO_LOG_WARN("[loadCSV] Skipping invalid value '" << value << "'");
             }
         }
 
         if (row.size() < 2) {
-            std::cerr << "[loadCSV] Skipping line with insufficient columns\n";
+            ECO_LOG_WARN("[loadCSV] Skipping line with insufficient columns");
             continue;
         }
 
         ds.y.push_back(row.back());
-        row.pop_back();
-        ds.X.push_back(row);
+        ds.X.emplace_back(row.begin(), row.end() - 1);
     }
     return ds;
 }
@@ -1,6 +1,9 @@
 #include "domain.h"
 #include <stdexcept>
 #include <numeric>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
 
 // ==========================================
 // EcofunctionalVector
@@ -21,8 +24,23 @@ std::vector<float> EcofunctionalVector::toVector() const {
     };
 }
 
+std::array<float, ECOVECTOR_SIZE> EcofunctionalVector::toArray() const {
+    return {
+        soilDepth,
+        soilCompaction,
+        soilInfiltration,
+        hydroFlux,
+        erosionRisk,
+        vegetationCoverageEI,
+        vegetationCoverageES,
+        vegetationVigorEI,
+        vegetationVigorES,
+        propagulePotential
+    };
+}
+
 EcofunctionalVector EcofunctionalVector::fromVector(const std::vector<float>& vec) {
-    if (vec.size() != 10) {
+    if (vec.size() != ECOVECTOR_SIZE) {
         throw std::invalid_argument("Vector size must be 10 for EcofunctionalVector");
     }
     return EcofunctionalVector{
@@ -31,6 +49,13 @@ EcofunctionalVector EcofunctionalVector::fromVector(const std::vector<float>& ve
     };
 }
 
+EcofunctionalVector EcofunctionalVector::fromArray(const std::array<float, ECOVECTOR_SIZE>& arr) {
+    return EcofunctionalVector{
+        arr[0], arr[1], arr[2], arr[3], arr[4],
+        arr[5], arr[6], arr[7], arr[8], arr[9]
+    };
+}
+
 EcofunctionalVector EcofunctionalVector::operator-(const EcofunctionalVector& other) const {
     return {
         soilDepth - other.soilDepth,
@@ -76,21 +101,133 @@ EcofunctionalVector EcofunctionalVector::operator/(float scalar) const {
     };
 }
 
+// ==========================================
+// EcofunctionalSampleStore
+// ==========================================
+
+EcofunctionalSampleStore EcofunctionalSampleStore::bounded(size_t capacity) {
+    if (capacity == 0) {
+        throw std::invalid_argument("Bounded sample store needs a capacity of at least 1");
+    }
+    EcofunctionalSampleStore store;
+    store.capacity_ = capacity;
+    for (auto& column : store.attributes_) {
+        column.assign(2 * capacity, 0.0f);
+    }
+    store.labels_.assign(2 * capacity, 0.0f);
+    return store;
+}
+
+void EcofunctionalSampleStore::push_back(const EcofunctionalSample& sample) {
+    auto values = sample.inputVector.toArray();
+    if (capacity_) {
+        // Overwrite the oldest slot (and its mirror) once the ring is full
+        const size_t slot = (first_ + retained_) % capacity_;
+        for (size_t i = 0; i < ECOVECTOR_SIZE; ++i) {
+            attributes_[i][slot] = values[i];
+            attributes_[i][slot + capacity_] = values[i];
+        }
+        labels_[slot] = sample.targetLabel;
+        labels_[slot + capacity_] = sample.targetLabel;
+        if (retained_ < capacity_) {
+            retained_++;
+        } else {
+            first_ = (first_ + 1) % capacity_;
+        }
+        return;
+    }
+    for (size_t i = 0; i < ECOVECTOR_SIZE; ++i) {
+        attributes_[i].push_back(values[i]);
+    }
+    labels_.push_back(sample.targetLabel);
+}
+
+void EcofunctionalSampleStore::appendColumns(const std::array<const float*, ECOVECTOR_SIZE>& attributes,
+                                             const float* labels, size_t count) {
+    if (capacity_) {
+        // Only the rows that stay in the ring are written
+        const size_t skip = count > capacity_ ? count - capacity_ : 0;
+        for (size_t r = skip; r < count; ++r) {
+            std::array<float, ECOVECTOR_SIZE> values;
+            for (size_t i = 0; i < ECOVECTOR_SIZE; ++i) {
+                values[i] = attributes[i][r];
+            }
+            push_back({EcofunctionalVector::fromArray(values), labels ? labels[r] : 0.0f});
+        }
+        return;
+    }
+    for (size_t i = 0; i < ECOVECTOR_SIZE; ++i) {
+        attributes_[i].insert(attributes_[i].end(), attributes[i], attributes[i] + count);
+    }
+    if (labels) {
+        labels_.insert(labels_.end(), labels, labels + count);
+    } else {
+        labels_.resize(labels_.size() + count, 0.0f);
+    }
+}
+
+void EcofunctionalSampleStore::reserve(size_t count) {
+    if (capacity_) return;
+    for (auto& column : attributes_) {
+        column.reserve(count);
+    }
+    labels_.reserve(count);
+}
+
+EcofunctionalSample EcofunctionalSampleStore::operator[](size_t index) const {
+    return {vectorAt(index), labels_[first_ + index]};
+}
+
+EcofunctionalVector EcofunctionalSampleStore::vectorAt(size_t index) const {
+    std::array<float, ECOVECTOR_SIZE> values;
+    for (size_t i = 0; i < ECOVECTOR_SIZE; ++i) {
+        values[i] = attributes_[i][first_ + index];
+    }
+    return EcofunctionalVector::fromArray(values);
+}
+
+// ==========================================
+// EcofunctionalFeatureState
+// ==========================================
+
+void EcofunctionalFeatureState::push(const EcofunctionalVector& sample) {
+    ActiveFeaturePipeline::push(pipeline, sample.toArray(), steps);
+    delta = (steps > 0) ? sample - current : EcofunctionalVector{};
+    current = sample;
+    steps++;
+
+    // Simplified aggregated trend for vegetation
+    vegetationTrend = (delta.vegetationCoverageEI + delta.vegetationCoverageES +
+                       delta.vegetationVigorEI + delta.vegetationVigorES) / 4.0f;
+    // Hydro trend: +HydroFlux is usually good, +Infiltration is good.
+    hydroTrend = (delta.hydroFlux + delta.soilInfiltration) / 2.0f;
+}
+
+FeatureVector EcofunctionalFeatureState::featureRow() const {
+    FeatureVector features{};
+    if (steps > 0) {
+        ActiveFeaturePipeline::write(pipeline, features.data());
+    }
+    return features;
+}
+
 // ==========================================
 // EcofunctionalTrajectory
 // ==========================================
 
+EcofunctionalTrajectory EcofunctionalTrajectory::bounded(size_t capacity) {
+    EcofunctionalTrajectory trajectory;
+    trajectory.history = EcofunctionalSampleStore::bounded(capacity);
+    return trajectory;
+}
+
 void EcofunctionalTrajectory::addSample(const EcofunctionalSample& sample) {
     history.push_back(sample);
+    featureState.push(sample.inputVector);
 }
 
 EcofunctionalVector EcofunctionalTrajectory::calculateDelta() const {
-    if (history.size() < 2) {
-        return EcofunctionalVector{0}; // No change if not enough history
-    }
-    const auto& last = history.back().inputVector;
-    const auto& prev = history[history.size() - 2].inputVector;
-    return last - prev;
+    return featureState.delta; // Zero if not enough history
 }
 
 EcofunctionalVector EcofunctionalTrajectory::calculateAverage(int windowSize) const {
@@ -101,7 +238,7 @@ EcofunctionalVector EcofunctionalTrajectory::calculateAverage(int windowSize) co
     
     // Iterate backwards
     for (int i = history.size() - 1; i >= 0 && count < windowSize; --i) {
-        sum = sum + history[i].inputVector;
+        sum = sum + history.vectorAt(i);
         count++;
     }
     
@@ -109,27 +246,29 @@ EcofunctionalVector EcofunctionalTrajectory::calculateAverage(int windowSize) co
 }
 
 float EcofunctionalTrajectory::getVegetationTrend() const {
-    EcofunctionalVector delta = calculateDelta();
-    // Simplified aggregated trend for vegetation
-    return (delta.vegetationCoverageEI + delta.vegetationCoverageES + 
-            delta.vegetationVigorEI + delta.vegetationVigorES) / 4.0f;
+    return featureState.vegetationTrend;
 }
 
 float EcofunctionalTrajectory::getHydroTrend() const {
-    EcofunctionalVector delta = calculateDelta();
-    // Hydro trend: +HydroFlux is usually good, +Infiltration is good.
-    return (delta.hydroFlux + delta.soilInfiltration) / 2.0f;
+    return featureState.hydroTrend;
 }
 
 EcofunctionalTrajectory::TrajectoryState EcofunctionalTrajectory::analyzeState() const {
-    if (history.size() < 2) return TrajectoryState::UNKNOWN;
+    return classifyState(featureState);
+}
 
-    float vegTrend = getVegetationTrend();
-    float totalDeltaMagnitude = 0; // sum of absolute deltas could be used to detect stability
-    
-    // Heuristic Thresholds (To be calibrated)
-    const float STABILITY_THRESHOLD = 0.01f;
-    const float RECOVERY_THRESHOLD = 0.05f;
+namespace {
+// Heuristic Thresholds (To be calibrated)
+constexpr float STABILITY_THRESHOLD = 0.01f;
+constexpr float RECOVERY_THRESHOLD = 0.05f;
+// Steps classifyStates handles per inner loop
+constexpr size_t CLASSIFY_BLOCK = 64;
+} // namespace
+
+EcofunctionalTrajectory::TrajectoryState EcofunctionalTrajectory::classifyState(const EcofunctionalFeatureState& state) {
+    if (state.steps < 2) return TrajectoryState::UNKNOWN;
+
+    float vegTrend = state.vegetationTrend;
 
     if (std::abs(vegTrend) < STABILITY_THRESHOLD) {
         return TrajectoryState::STABLE;
@@ -144,6 +283,62 @@ EcofunctionalTrajectory::TrajectoryState EcofunctionalTrajectory::analyzeState()
     return TrajectoryState::STABLE; // Default fallback
 }
 
+void EcofunctionalTrajectory::classifyStates(const float* vegetationTrends, const size_t* steps, size_t count,
+                                             TrajectoryState* out) {
+    static_assert(static_cast<int>(TrajectoryState::STABLE) == 0 &&
+                  static_cast<int>(TrajectoryState::RECOVERING) == 1 &&
+                  static_cast<int>(TrajectoryState::DEGRADING) == 2 &&
+                  static_cast<int>(TrajectoryState::COLLAPSING) == 3 &&
+                  static_cast<int>(TrajectoryState::UNKNOWN) == 4,
+                  "classifyStates computes the enum values arithmetically");
+
+    for (size_t begin = 0; begin < count; begin += CLASSIFY_BLOCK) {
+        const size_t n = std::min(CLASSIFY_BLOCK, count - begin);
+        // 32-bit lanes like the trends, so the loop below vectorizes even without AVX2
+        int32_t warmedUp[CLASSIFY_BLOCK];
+        for (size_t i = 0; i < n; ++i)
+            warmedUp[i] = steps[begin + i] >= 2;
+
+        // classifyState's if/else chain as arithmetic on 0/1 masks (written as
+        // selects, the compiler turns the chain back into branches):
+        // stable excludes recovering and collapsing, collapsing implies negative.
+        // A NaN trend fails every test and stays STABLE, as in classifyState.
+        for (size_t i = 0; i < n; ++i) {
+            const float vegTrend = vegetationTrends[begin + i];
+            const int32_t stable = std::abs(vegTrend) < STABILITY_THRESHOLD;
+            const int32_t recovering = vegTrend > RECOVERY_THRESHOLD;
+            const int32_t collapsing = vegTrend < -RECOVERY_THRESHOLD;
+            const int32_t negative = vegTrend < 0;
+            // RECOVERING = 1, DEGRADING = 2, COLLAPSING = 3, STABLE = 0
+            const int32_t state = recovering + collapsing + 2 * (negative & (1 - stable));
+            out[begin + i] = static_cast<TrajectoryState>(warmedUp[i] * state + (1 - warmedUp[i]) * 4);
+        }
+    }
+}
+
+// ==========================================
+// TrajectoryCursor
+// ==========================================
+
+TrajectoryCursor::TrajectoryCursor(const EcofunctionalTrajectory& trajectory)
+    : history_(trajectory.history) {}
+
+bool TrajectoryCursor::next() {
+    if (position_ >= history_.size()) return false;
+
+    state_.push(history_.vectorAt(position_));
+    position_++;
+    return true;
+}
+
+size_t TrajectoryCursor::position() const {
+    return position_;
+}
+
+const EcofunctionalFeatureState& TrajectoryCursor::featureState() const {
+    return state_;
+}
+
 
 // ==========================================
 // EcofunctionalExperiment
@@ -156,7 +351,11 @@ void EcofunctionalExperiment::addSample(const EcofunctionalSample& sample) {
     samples_.push_back(sample);
 }
 
-const std::vector<EcofunctionalSample>& EcofunctionalExperiment::getSamples() const {
+const EcofunctionalSampleStore& EcofunctionalExperiment::getSamples() const {
+    return samples_;
+}
+
+EcofunctionalSampleStore& EcofunctionalExperiment::mutableSamples() {
     return samples_;
 }
 
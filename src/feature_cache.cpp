@@ -0,0 +1,188 @@
+#include "feature_cache.h"
+#include "checksum.h"
+#include "logging.h"
+#include "mapped_file.h"
+#include "services.h"
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <tuple>
+
+namespace {
+
+constexpr char FEATURE_CACHE_MAGIC[8] = {'E', 'C', 'O', 'F', 'E', 'A', 'T', '\0'};
+
+struct FeatureCacheHeader {
+    char magic[8];
+    uint32_t pipelineVersion;
+    uint32_t featureWidth;
+    uint64_t rowCount;
+    uint64_t contentHash;
+    int32_t windowSize;
+    uint32_t reserved;
+    uint64_t payloadHash; // FNV-1a of the feature rows
+};
+
+} // namespace
+
+// ==========================================
+// FeatureMatrixKey
+// ==========================================
+
+FeatureMatrixKey FeatureMatrixKey::forExperiment(const EcofunctionalExperiment& experiment, int windowSize) {
+    const auto& samples = experiment.getSamples();
+    uint64_t hash = FNV1A_OFFSET_BASIS;
+    for (size_t c = 0; c < ECOVECTOR_SIZE; ++c) {
+        ColumnView column = samples.attribute(c);
+        hash = fnv1a(hash, column.data, column.size * sizeof(float));
+    }
+    ColumnView labels = samples.labels();
+    hash = fnv1a(hash, labels.data, labels.size * sizeof(float));
+
+    FeatureMatrixKey key;
+    key.experimentId = experiment.getId();
+    key.contentHash = hash;
+    key.rowCount = samples.size();
+    key.windowSize = windowSize;
+    return key;
+}
+
+std::string FeatureMatrixKey::toString() const {
+    std::string safeId = experimentId;
+    for (char& c : safeId) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '_') c = '_';
+    }
+    char hash[17];
+    std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(contentHash));
+    std::string window = (windowSize == 0) ? "" : "-w" + std::to_string(windowSize);
+    return safeId + "-" + hash + window + ".v" + std::to_string(pipelineVersion);
+}
+
+bool FeatureMatrixKey::operator<(const FeatureMatrixKey& other) const {
+    return std::tie(experimentId, contentHash, rowCount, windowSize, pipelineVersion) <
+           std::tie(other.experimentId, other.contentHash, other.rowCount, other.windowSize, other.pipelineVersion);
+}
+
+// ==========================================
+// FeatureMatrixCache
+// ==========================================
+
+FeatureMatrixCache::FeatureMatrixCache(std::string persistDirectory)
+    : persistDirectory_(std::move(persistDirectory)) {}
+
+std::shared_ptr<const FeatureMatrix> FeatureMatrixCache::get(const EcofunctionalExperiment& experiment,
+                                                             int windowSize) {
+    FeatureMatrixKey key = FeatureMatrixKey::forExperiment(experiment, windowSize);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto found = entries_.find(key);
+    if (found != entries_.end()) {
+        hits_++;
+        std::shared_future<std::shared_ptr<const FeatureMatrix>> pending = found->second;
+        lock.unlock();
+        return pending.get(); // waits if another thread is still building it
+    }
+    std::promise<std::shared_ptr<const FeatureMatrix>> promise;
+    entries_.emplace(key, promise.get_future().share());
+    lock.unlock();
+
+    try {
+        std::shared_ptr<const FeatureMatrix> matrix = loadPersisted(key);
+        const bool loaded = matrix != nullptr;
+        if (!loaded) {
+            matrix = std::make_shared<const FeatureMatrix>(buildFeatureMatrix(experiment.getSamples(), windowSize));
+            persist(key, *matrix);
+        }
+        lock.lock();
+        (loaded ? hits_ : misses_)++;
+        lock.unlock();
+        promise.set_value(matrix);
+        return matrix;
+    } catch (...) {
+        // Waiters see the error; later calls try again
+        lock.lock();
+        entries_.erase(key);
+        lock.unlock();
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+}
+
+size_t FeatureMatrixCache::hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+size_t FeatureMatrixCache::misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+std::string FeatureMatrixCache::persistPath(const FeatureMatrixKey& key) const {
+    return (std::filesystem::path(persistDirectory_) / (key.toString() + ".features")).string();
+}
+
+std::shared_ptr<const FeatureMatrix> FeatureMatrixCache::loadPersisted(const FeatureMatrixKey& key) const {
+    if (persistDirectory_.empty()) return nullptr;
+
+    MappedFile file;
+    if (!file.open(persistPath(key)) || file.size() < sizeof(FeatureCacheHeader)) return nullptr;
+
+    FeatureCacheHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    const bool valid = std::memcmp(header.magic, FEATURE_CACHE_MAGIC, sizeof(header.magic)) == 0 &&
+                       header.pipelineVersion == key.pipelineVersion &&
+                       header.featureWidth == ECOFEATURE_VECTOR_SIZE &&
+                       header.rowCount == key.rowCount &&
+                       header.contentHash == key.contentHash &&
+                       header.windowSize == key.windowSize &&
+                       file.size() == sizeof(header) + header.rowCount * sizeof(FeatureVector) &&
+                       fnv1a(FNV1A_OFFSET_BASIS, file.data() + sizeof(header),
+                             header.rowCount * sizeof(FeatureVector)) == header.payloadHash;
+    if (!valid) {
+        ECO_LOG_WARN("[FeatureCache] Ignoring stale or corrupt cache file " << persistPath(key));
+        return nullptr;
+    }
+
+    auto matrix = std::make_shared<FeatureMatrix>(header.rowCount);
+    std::memcpy(matrix->data(), file.data() + sizeof(header), header.rowCount * sizeof(FeatureVector));
+    return matrix;
+}
+
+void FeatureMatrixCache::persist(const FeatureMatrixKey& key, const FeatureMatrix& matrix) const {
+    if (persistDirectory_.empty()) return;
+
+    FeatureCacheHeader header{};
+    std::memcpy(header.magic, FEATURE_CACHE_MAGIC, sizeof(header.magic));
+    header.pipelineVersion = key.pipelineVersion;
+    header.featureWidth = ECOFEATURE_VECTOR_SIZE;
+    header.rowCount = matrix.size();
+    header.contentHash = key.contentHash;
+    header.windowSize = key.windowSize;
+    header.payloadHash = fnv1a(FNV1A_OFFSET_BASIS, matrix.data(), matrix.size() * sizeof(FeatureVector));
+
+    // Write to a temporary name and rename, so readers never see a partial file
+    const std::string path = persistPath(key);
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary);
+        if (!out.is_open()) {
+            ECO_LOG_WARN("[FeatureCache] Cannot write cache file " << path);
+            return;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(matrix.data()),
+                  static_cast<std::streamsize>(matrix.size() * sizeof(FeatureVector)));
+        if (!out) {
+            ECO_LOG_WARN("[FeatureCache] Failed writing cache file " << path);
+            return;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(tmpPath, path, error);
+    if (error) {
+        ECO_LOG_WARN("[FeatureCache] Cannot persist cache file " << path << ": " << error.message());
+    }
+}
@@ -0,0 +1,54 @@
+#include "fleet.h"
+#include "services.h"
+#include "result_sink.h"
+#include "instrumentation.h"
+#include <algorithm>
+
+FleetInferenceEngine::FleetInferenceEngine(size_t threads)
+    : pool_(threads) {}
+
+std::vector<PlotInferenceResult> FleetInferenceEngine::run(const Perceptron& model,
+                                                           const std::vector<PlotTrajectory>& plots) {
+    ECO_TIME_SCOPE("fleet.run");
+    std::vector<PlotInferenceResult> results(plots.size());
+
+    pool_.parallelFor(plots.size(), [&](size_t p) {
+        PerceptronInferenceService inferenceService;
+        results[p].plotId = plots[p].plotId;
+        results[p].steps = inferenceService.replay(model, plots[p].trajectory);
+    });
+
+    return results;
+}
+
+std::vector<PlotInferenceSummary> FleetInferenceEngine::run(const Perceptron& model,
+                                                            const std::vector<PlotTrajectory>& plots,
+                                                            InferenceResultSink& sink) {
+    ECO_TIME_SCOPE("fleet.run");
+    std::vector<PlotInferenceSummary> summaries(plots.size());
+
+    pool_.parallelFor(plots.size(), [&](size_t p) {
+        PerceptronInferenceService inferenceService;
+        PlotInferenceSummary& summary = summaries[p];
+        summary.plotId = plots[p].plotId;
+
+        std::vector<InferenceOutput> chunk;
+        chunk.reserve(std::min(FLEET_SINK_CHUNK, plots[p].trajectory.history.size()));
+        size_t chunkStart = 0;
+        inferenceService.replay(model, plots[p].trajectory, [&](size_t step, const InferenceOutput& output) {
+            chunk.push_back(output);
+            if (chunk.size() == FLEET_SINK_CHUNK) {
+                sink.write(summary.plotId, chunkStart, chunk.data(), chunk.size());
+                chunkStart = step + 1;
+                chunk.clear();
+            }
+            summary.steps = step + 1;
+            summary.last = output;
+        });
+        if (!chunk.empty()) {
+            sink.write(summary.plotId, chunkStart, chunk.data(), chunk.size());
+        }
+    });
+
+    return summaries;
+}
@@ -0,0 +1,497 @@
+#include "inference_server.h"
+#include "csv_reader.h"
+#include "instrumentation.h"
+#include "logging.h"
+#include "result_sink.h"
+#include "services.h"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ECO_HAS_UNIX_SOCKETS 1
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+// ==========================================
+// InferenceBatcher
+// ==========================================
+
+InferenceBatcher::InferenceBatcher(const Perceptron& model, InferenceServerOptions options)
+    : model_(model), options_(options) {
+    if (options_.maxBatch == 0) {
+        throw std::invalid_argument("Inference batches need room for at least one request");
+    }
+    rows_.reserve(options_.maxBatch);
+    scores_.reserve(options_.maxBatch);
+    vegetationTrends_.reserve(options_.maxBatch);
+    steps_.reserve(options_.maxBatch);
+    states_.reserve(options_.maxBatch);
+    outputs_.reserve(options_.maxBatch);
+    worker_ = std::thread(&InferenceBatcher::run, this);
+}
+
+InferenceBatcher::~InferenceBatcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    worker_.join();
+}
+
+void InferenceBatcher::submit(std::string plotId, const EcofunctionalVector& sample,
+                              std::shared_ptr<InferenceReplyChannel> channel) {
+    enqueue({RequestKind::SAMPLE, std::move(plotId), sample, std::move(channel)});
+}
+
+void InferenceBatcher::resetPlot(std::string plotId, std::shared_ptr<InferenceReplyChannel> channel) {
+    enqueue({RequestKind::RESET, std::move(plotId), {}, std::move(channel)});
+}
+
+void InferenceBatcher::requestStats(std::shared_ptr<InferenceReplyChannel> channel) {
+    enqueue({RequestKind::STATS, {}, {}, std::move(channel)});
+}
+
+void InferenceBatcher::reportError(std::string message, std::shared_ptr<InferenceReplyChannel> channel) {
+    enqueue({RequestKind::ERROR, std::move(message), {}, std::move(channel)});
+}
+
+void InferenceBatcher::enqueue(Request request) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(std::move(request));
+    }
+    wake_.notify_one();
+}
+
+void InferenceBatcher::drain() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [&] { return queue_.empty() && !busy_; });
+}
+
+InferenceServerStats InferenceBatcher::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void InferenceBatcher::run() {
+    std::vector<Request> batch;
+    batch.reserve(options_.maxBatch);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        wake_.wait(lock, [&] { return stopping_ || !queue_.empty(); });
+        if (queue_.empty()) break; // Stopping with nothing left to answer
+
+        if (options_.batchWindow.count() > 0 && queue_.size() < options_.maxBatch && !stopping_) {
+            wake_.wait_for(lock, options_.batchWindow,
+                           [&] { return stopping_ || queue_.size() >= options_.maxBatch; });
+        }
+
+        const size_t take = std::min(queue_.size(), options_.maxBatch);
+        for (size_t i = 0; i < take; ++i) {
+            batch.push_back(std::move(queue_.front()));
+            queue_.pop_front();
+        }
+        busy_ = true;
+        lock.unlock();
+
+        process(batch);
+        batch.clear();
+
+        lock.lock();
+        busy_ = false;
+        if (queue_.empty()) idle_.notify_all();
+    }
+    idle_.notify_all();
+}
+
+void InferenceBatcher::process(std::vector<Request>& batch) {
+    ECO_TIME_SCOPE("server.batch");
+    rows_.clear();
+    vegetationTrends_.clear();
+    steps_.clear();
+
+    // Plot streams advance in arrival order, so several samples of one plot
+    // in the same batch each see the state right after their own sample
+    for (const Request& request : batch) {
+        if (request.kind == RequestKind::SAMPLE) {
+            EcofunctionalFeatureState& state = plots_[request.plotId];
+            state.push(request.sample);
+
+            rows_.push_back(state.featureRow());
+            vegetationTrends_.push_back(state.vegetationTrend);
+            steps_.push_back(state.steps);
+        } else if (request.kind == RequestKind::RESET) {
+            plots_.erase(request.plotId);
+        }
+    }
+
+    const size_t samples = rows_.size();
+    scores_.resize(samples);
+    states_.resize(samples);
+    outputs_.resize(samples);
+    // Scalar kernel so every score, and hence every classification at the
+    // interpretScore thresholds, matches --fleet and replay exactly
+    model_.inferBatchScalar(rows_.data(), samples, scores_.data());
+    EcofunctionalTrajectory::classifyStates(vegetationTrends_.data(), steps_.data(), samples, states_.data());
+    PerceptronInferenceService::interpretScores(scores_.data(), states_.data(), vegetationTrends_.data(),
+                                                samples, outputs_.data());
+
+    InferenceServerStats snapshot;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.requests += batch.size();
+        stats_.batches++;
+        stats_.largestBatch = std::max(stats_.largestBatch, batch.size());
+        stats_.plots = plots_.size();
+        snapshot = stats_;
+    }
+    ECO_COUNT("server.requests", batch.size());
+
+    // Replies in request order; every channel is flushed once at the end
+    std::vector<InferenceReplyChannel*> touched;
+    size_t next = 0;
+    for (const Request& request : batch) {
+        InferenceReplyChannel& channel = *request.channel;
+        switch (request.kind) {
+            case RequestKind::SAMPLE:
+                channel.reply(request.plotId, steps_[next] - 1, outputs_[next]);
+                next++;
+                break;
+            case RequestKind::RESET: {
+                std::string json = "{\"plot_id\":";
+                appendJsonString(json, request.plotId);
+                json += ",\"reset\":true}";
+                channel.replyJson(json);
+                break;
+            }
+            case RequestKind::STATS:
+                channel.replyJson("{\"requests\":" + std::to_string(snapshot.requests) +
+                                  ",\"batches\":" + std::to_string(snapshot.batches) +
+                                  ",\"largest_batch\":" + std::to_string(snapshot.largestBatch) +
+                                  ",\"plots\":" + std::to_string(snapshot.plots) + "}");
+                break;
+            case RequestKind::ERROR: {
+                std::string json = "{\"error\":";
+                appendJsonString(json, request.plotId);
+                json += '}';
+                channel.replyJson(json);
+                break;
+            }
+        }
+        if (std::find(touched.begin(), touched.end(), &channel) == touched.end()) {
+            touched.push_back(&channel);
+        }
+    }
+    for (InferenceReplyChannel* channel : touched) {
+        channel->flush();
+    }
+}
+
+// ==========================================
+// Line protocol
+// ==========================================
+
+namespace {
+
+std::string_view trim(std::string_view text) {
+    const auto first = text.find_first_not_of(" \t\r");
+    if (first == std::string_view::npos) return {};
+    const auto last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+// NDJSON lines accumulated per batch and written by the transport on flush()
+class BufferedReplyChannel : public InferenceReplyChannel {
+public:
+    void reply(std::string_view plotId, size_t step, const InferenceOutput& output) override {
+        appendNdjsonResult(pending_, plotId, step, output);
+    }
+    void replyJson(const std::string& json) override {
+        pending_ += json;
+        pending_ += '\n';
+    }
+    void flush() override {
+        if (pending_.empty()) return;
+        write(pending_);
+        pending_.clear();
+    }
+
+protected:
+    virtual void write(const std::string& bytes) = 0;
+
+private:
+    std::string pending_;
+};
+
+class StreamReplyChannel : public BufferedReplyChannel {
+public:
+    explicit StreamReplyChannel(std::ostream& out) : out_(out) {}
+
+protected:
+    void write(const std::string& bytes) override {
+        out_.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        out_.flush();
+    }
+
+private:
+    std::ostream& out_;
+};
+
+} // namespace
+
+void submitProtocolLine(InferenceBatcher& batcher, std::string_view line,
+                        const std::shared_ptr<InferenceReplyChannel>& channel) {
+    line = trim(line);
+    if (line.empty()) return;
+
+    if (line.front() == '!') {
+        const auto space = line.find(' ');
+        const std::string_view command = line.substr(0, space);
+        const std::string_view argument = (space == std::string_view::npos) ? std::string_view{}
+                                                                            : trim(line.substr(space + 1));
+        if (command == "!reset" && !argument.empty()) {
+            batcher.resetPlot(std::string(argument), channel);
+        } else if (command == "!stats") {
+            batcher.requestStats(channel);
+        } else {
+            batcher.reportError("Unknown command: " + std::string(line), channel);
+        }
+        return;
+    }
+
+    CsvFieldReader fields(line);
+    std::string_view plotId;
+    if (!fields.next(plotId) || trim(plotId).empty()) {
+        batcher.reportError("Missing plot id", channel);
+        return;
+    }
+    std::array<float, ECOVECTOR_SIZE> values;
+    std::vector<CsvDiagnostic> diagnostics;
+    const size_t count = parseFloatFields(fields, values.data(), values.size(), diagnostics, 0);
+    if (count < ECOVECTOR_SIZE || !diagnostics.empty()) {
+        batcher.reportError(diagnostics.empty()
+                                ? "Expected a plot id and " + std::to_string(ECOVECTOR_SIZE) +
+                                      " attributes, got " + std::to_string(count)
+                                : diagnostics.front().message,
+                            channel);
+        return;
+    }
+    batcher.submit(std::string(trim(plotId)), EcofunctionalVector::fromArray(values), channel);
+}
+
+void serveStream(InferenceBatcher& batcher, std::istream& in, std::ostream& out) {
+    auto channel = std::make_shared<StreamReplyChannel>(out);
+    std::string line;
+    while (std::getline(in, line)) {
+        submitProtocolLine(batcher, line, channel);
+    }
+    batcher.drain();
+}
+
+// ==========================================
+// Unix domain socket transport
+// ==========================================
+
+#ifdef ECO_HAS_UNIX_SOCKETS
+
+namespace {
+
+constexpr int ACCEPT_POLL_MS = 200; // How often the accept loop checks 'stop'
+constexpr size_t READ_BUFFER_BYTES = 64 * 1024;
+// Replies a client may leave unread before it is disconnected, so one stalled
+// client costs memory up to this bound and never delays the batcher
+constexpr size_t MAX_PENDING_REPLY_BYTES = 16 * 1024 * 1024;
+constexpr int SEND_TIMEOUT_SECONDS = 5; // A send blocked this long also drops the client
+
+// Replies waiting for a client's writer thread
+struct ReplyOutbox {
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::string pending;
+    bool closed = false; // No more replies: the reader is done and every request was answered
+    bool broken = false; // Client gone or stalled; replies are discarded
+};
+
+// Batcher side of a client: flush() only moves the batch's bytes to the
+// outbox, and the client's writer thread sends them
+class SocketReplyChannel : public BufferedReplyChannel {
+public:
+    SocketReplyChannel(int fd, std::shared_ptr<ReplyOutbox> outbox) : fd_(fd), outbox_(std::move(outbox)) {}
+    ~SocketReplyChannel() override {
+        {
+            std::lock_guard<std::mutex> lock(outbox_->mutex);
+            outbox_->closed = true;
+        }
+        outbox_->ready.notify_one();
+    }
+
+protected:
+    void write(const std::string& bytes) override {
+        {
+            std::lock_guard<std::mutex> lock(outbox_->mutex);
+            if (outbox_->broken) return;
+            if (outbox_->pending.size() + bytes.size() > MAX_PENDING_REPLY_BYTES) {
+                ECO_LOG_WARN("[Server] Client is not reading its replies; disconnecting it");
+                outbox_->broken = true;
+                outbox_->pending.clear();
+                ::shutdown(fd_, SHUT_RDWR); // Also ends its reader
+                return;
+            }
+            outbox_->pending += bytes;
+        }
+        outbox_->ready.notify_one();
+    }
+
+private:
+    int fd_;
+    std::shared_ptr<ReplyOutbox> outbox_;
+};
+
+// The descriptor is closed by closeClient once both threads are done: the
+// reader at end of input, the writer once the outbox is closed and sent
+struct ClientConnection {
+    int fd = -1;
+    std::shared_ptr<ReplyOutbox> outbox = std::make_shared<ReplyOutbox>();
+    std::thread reader;
+    std::thread writer;
+    std::atomic<bool> finished{false}; // Set by the writer as it exits
+};
+
+void readClient(InferenceBatcher& batcher, int fd, std::shared_ptr<InferenceReplyChannel> channel) {
+    std::string pending;
+    std::vector<char> buffer(READ_BUFFER_BYTES);
+    while (true) {
+        const ssize_t n = ::recv(fd, buffer.data(), buffer.size(), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        pending.append(buffer.data(), static_cast<size_t>(n));
+
+        size_t start = 0;
+        for (size_t newline; (newline = pending.find('\n', start)) != std::string::npos; start = newline + 1) {
+            submitProtocolLine(batcher, std::string_view(pending).substr(start, newline - start), channel);
+        }
+        pending.erase(0, start);
+    }
+    if (!pending.empty()) {
+        submitProtocolLine(batcher, pending, channel);
+    }
+    // Queued requests keep the channel, and so the outbox, open until answered
+}
+
+void writeClient(ClientConnection& client) {
+    ReplyOutbox& outbox = *client.outbox;
+    std::string sending;
+    std::unique_lock<std::mutex> lock(outbox.mutex);
+    while (true) {
+        outbox.ready.wait(lock, [&] { return outbox.closed || !outbox.pending.empty(); });
+        if (outbox.pending.empty()) break; // Closed and everything sent
+        sending.swap(outbox.pending);
+        outbox.pending.clear();
+        const bool discard = outbox.broken;
+        lock.unlock();
+
+        size_t sent = 0;
+        while (!discard && sent < sending.size()) {
+            const ssize_t n = ::send(client.fd, sending.data() + sent, sending.size() - sent, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break; // Client went away or stopped reading; its remaining replies are dropped
+            sent += static_cast<size_t>(n);
+        }
+
+        lock.lock();
+        if (!discard && sent < sending.size()) {
+            outbox.broken = true;
+            outbox.pending.clear();
+        }
+    }
+    client.finished = true;
+}
+
+void closeClient(ClientConnection& client) {
+    if (client.reader.joinable()) client.reader.join();
+    if (client.writer.joinable()) client.writer.join();
+    ::close(client.fd);
+}
+
+} // namespace
+
+void serveUnixSocket(InferenceBatcher& batcher, const std::string& path, const std::atomic<bool>& stop) {
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Socket path too long: " + path);
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    const int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        throw std::runtime_error(std::string("Cannot create socket: ") + std::strerror(errno));
+    }
+    ::unlink(path.c_str());
+    if (::bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listener, SOMAXCONN) != 0) {
+        const std::string reason = std::strerror(errno);
+        ::close(listener);
+        throw std::runtime_error("Cannot listen on " + path + ": " + reason);
+    }
+    ECO_LOG_INFO("[Server] Listening on " << path);
+
+    std::vector<std::unique_ptr<ClientConnection>> clients;
+    while (!stop) {
+        pollfd waiting{listener, POLLIN, 0};
+        const int ready = ::poll(&waiting, 1, ACCEPT_POLL_MS);
+
+        // Reap clients that hung up
+        for (auto it = clients.begin(); it != clients.end();) {
+            if ((*it)->finished) {
+                closeClient(**it);
+                it = clients.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        if (ready <= 0 || !(waiting.revents & POLLIN)) continue;
+
+        const int fd = ::accept(listener, nullptr, nullptr);
+        if (fd < 0) continue;
+        const timeval sendTimeout{SEND_TIMEOUT_SECONDS, 0};
+        ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &sendTimeout, sizeof(sendTimeout));
+
+        auto client = std::make_unique<ClientConnection>();
+        client->fd = fd;
+        auto channel = std::make_shared<SocketReplyChannel>(fd, client->outbox);
+        ClientConnection& connection = *client;
+        connection.writer = std::thread([&connection] { writeClient(connection); });
+        connection.reader = std::thread([&batcher, fd, channel]() mutable { readClient(batcher, fd, std::move(channel)); });
+        clients.push_back(std::move(client));
+        ECO_LOG_DEBUG("[Server] Client connected (" << clients.size() << " open)");
+    }
+
+    // Wake the readers blocked in recv, then let the writers send the replies
+    // still owed (a stalled client is dropped after SEND_TIMEOUT_SECONDS)
+    for (auto& client : clients) {
+        ::shutdown(client->fd, SHUT_RD);
+    }
+    for (auto& client : clients) {
+        closeClient(*client);
+    }
+    ::close(listener);
+    ::unlink(path.c_str());
+}
+
+#else
+
+void serveUnixSocket(InferenceBatcher&, const std::string&, const std::atomic<bool>&) {
+    throw std::runtime_error("Unix domain sockets are not available on this platform; serve stdin instead");
+}
+
+#endif // ECO_HAS_UNIX_SOCKETS
@@ -0,0 +1,207 @@
+#include "instrumentation.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace instrumentation {
+
+#ifndef ECOPERCEPTRON_DISABLE_INSTRUMENTATION
+
+namespace {
+
+constexpr size_t MAX_TRACE_EVENTS_PER_THREAD = 1 << 20;
+
+struct StageStats {
+    uint64_t calls = 0;
+    int64_t totalNs = 0;
+    int64_t maxNs = 0;
+};
+
+struct TraceEvent {
+    size_t stage;
+    int64_t startNs;
+    int64_t durationNs;
+};
+
+// Written only by its owning thread
+struct ThreadProfile {
+    size_t threadIndex = 0;
+    std::vector<StageStats> stages;
+    std::vector<uint64_t> counters;
+    std::vector<TraceEvent> trace;
+    size_t droppedEvents = 0;
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<const char*> stageNames;
+    std::vector<const char*> counterNames;
+    std::vector<std::shared_ptr<ThreadProfile>> threads; // Kept after their thread exits
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+std::atomic<bool> tracing{false};
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const int64_t processStartNs = nowNs();
+
+ThreadProfile& threadProfile() {
+    thread_local std::shared_ptr<ThreadProfile> profile = [] {
+        auto created = std::make_shared<ThreadProfile>();
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        created->threadIndex = r.threads.size();
+        r.threads.push_back(created);
+        return created;
+    }();
+    return *profile;
+}
+
+size_t registerName(std::vector<const char*>& names, const char* name) {
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    // Same name from several call sites shares one slot
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (std::string(names[i]) == name) return i;
+    }
+    names.push_back(name);
+    return names.size() - 1;
+}
+
+} // namespace
+
+size_t registerStage(const char* name) {
+    return registerName(registry().stageNames, name);
+}
+
+size_t registerCounter(const char* name) {
+    return registerName(registry().counterNames, name);
+}
+
+void addCount(size_t counter, uint64_t value) {
+    ThreadProfile& profile = threadProfile();
+    if (counter >= profile.counters.size()) profile.counters.resize(counter + 1);
+    profile.counters[counter] += value;
+}
+
+ScopedTimer::ScopedTimer(size_t stage)
+    : stage_(stage), startNs_(nowNs()) {}
+
+ScopedTimer::~ScopedTimer() {
+    const int64_t durationNs = nowNs() - startNs_;
+    ThreadProfile& profile = threadProfile();
+    if (stage_ >= profile.stages.size()) profile.stages.resize(stage_ + 1);
+    StageStats& stats = profile.stages[stage_];
+    stats.calls++;
+    stats.totalNs += durationNs;
+    stats.maxNs = std::max(stats.maxNs, durationNs);
+
+    if (tracing.load(std::memory_order_relaxed)) {
+        if (profile.trace.size() < MAX_TRACE_EVENTS_PER_THREAD) {
+            profile.trace.push_back({stage_, startNs_, durationNs});
+        } else {
+            profile.droppedEvents++;
+        }
+    }
+}
+
+void enableTracing(bool enabled) {
+    tracing.store(enabled, std::memory_order_relaxed);
+}
+
+void writeSummary(std::ostream& out) {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    char line[160];
+    out << "\n[Profile] Stage                       Calls    Total ms     Mean ms      Max ms  Threads\n";
+    for (size_t s = 0; s < r.stageNames.size(); ++s) {
+        StageStats total;
+        size_t threads = 0;
+        for (const auto& profile : r.threads) {
+            if (s >= profile->stages.size() || profile->stages[s].calls == 0) continue;
+            const StageStats& stats = profile->stages[s];
+            total.calls += stats.calls;
+            total.totalNs += stats.totalNs;
+            total.maxNs = std::max(total.maxNs, stats.maxNs);
+            threads++;
+        }
+        if (total.calls == 0) continue;
+        std::snprintf(line, sizeof(line), "[Profile] %-24s %9llu %11.3f %11.3f %11.3f %8zu\n",
+                      r.stageNames[s], static_cast<unsigned long long>(total.calls), total.totalNs / 1e6,
+                      total.totalNs / 1e6 / total.calls, total.maxNs / 1e6, threads);
+        out << line;
+    }
+
+    for (size_t c = 0; c < r.counterNames.size(); ++c) {
+        uint64_t total = 0;
+        for (const auto& profile : r.threads) {
+            if (c < profile->counters.size()) total += profile->counters[c];
+        }
+        std::snprintf(line, sizeof(line), "[Profile] %-24s %12llu\n",
+                      r.counterNames[c], static_cast<unsigned long long>(total));
+        out << line;
+    }
+}
+
+void writeChromeTrace(const std::string& path) {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        throw std::runtime_error("Cannot write trace file: " + path);
+    }
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    char event[256];
+    size_t dropped = 0;
+    for (const auto& profile : r.threads) {
+        for (const TraceEvent& e : profile->trace) {
+            std::snprintf(event, sizeof(event),
+                          "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%zu,\"ts\":%.3f,\"dur\":%.3f}",
+                          first ? "" : ",", r.stageNames[e.stage], profile->threadIndex,
+                          (e.startNs - processStartNs) / 1e3, e.durationNs / 1e3);
+            out << event;
+            first = false;
+        }
+        dropped += profile->droppedEvents;
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":" << dropped << "}}\n";
+    if (!out) {
+        throw std::runtime_error("Failed writing trace file: " + path);
+    }
+}
+
+#else
+
+void enableTracing(bool) {}
+
+void writeSummary(std::ostream& out) {
+    out << "[Profile] Instrumentation was disabled at build time (ECOPERCEPTRON_INSTRUMENTATION=OFF)\n";
+}
+
+void writeChromeTrace(const std::string& path) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        throw std::runtime_error("Cannot write trace file: " + path);
+    }
+    out << "{\"traceEvents\":[]}\n";
+}
+
+#endif
+
+} // namespace instrumentation
@@ -0,0 +1,52 @@
+#include "logging.h"
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+
+namespace {
+
+std::atomic<int> currentLevel{static_cast<int>(LogLevel::INFO)};
+
+std::mutex& logMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+} // namespace
+
+void setLogLevel(LogLevel level) {
+    currentLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+LogLevel logLevel() {
+    return static_cast<LogLevel>(currentLevel.load(std::memory_order_relaxed));
+}
+
+bool logEnabled(LogLevel level) {
+    return static_cast<int>(level) <= currentLevel.load(std::memory_order_relaxed);
+}
+
+LogLevel parseLogLevel(const std::string& name) {
+    if (name == "error") return LogLevel::ERROR;
+    if (name == "warn") return LogLevel::WARN;
+    if (name == "info") return LogLevel::INFO;
+    if (name == "debug") return LogLevel::DEBUG;
+    throw std::invalid_argument("Unknown log level: " + name);
+}
+
+void logLine(LogLevel level, const std::string& line) {
+    std::lock_guard<std::mutex> lock(logMutex());
+    if (level <= LogLevel::WARN) {
+        std::cout.flush();
+        std::cerr << line << '\n';
+    } else {
+        std::cout << line << '\n';
+    }
+}
+
+void flushLog() {
+    std::lock_guard<std::mutex> lock(logMutex());
+    std::cout.flush();
+    std::cerr.flush();
+}
@@ -2,13 +2,19 @@
 #include <vector>
 #include <fstream>
 #include <filesystem>
+#include <stdexcept>
 #include "domain.h"
 #include "services.h"
 #include "perceptron.h"
 #include "data_loader.h"
-#include <nlohmann/json.hpp>
-
-using json = nlohmann::json;
+#include "fleet.h"
+#include "feature_cache.h"
+#include "sweep.h"
+#include "result_sink.h"
+#include "instrumentation.h"
+#include "logging.h"
+#include <sstream>
+#include <memory>
 
 void printResult(const std::string& label, const InferenceOutput& res) {
     std::cout << "\n[" << label << "]" << std::endl;
@@ -17,62 +23,225 @@ void printResult(const std::string& label, const InferenceOutput& res) {
     std::cout << "  Resilience Potential: " << res.resiliencePotential << std::endl;
 }
 
-// Save results to JSON for python plotting
-void saveInferenceLog(const std::string& filename, const std::vector<InferenceOutput>& history) {
-    json j;
-    std::vector<json> entries;
-    int t = 0;
-    for (const auto& log : history) {
-        entries.push_back({
-            {"step", t++},
-            {"functional_integrity", log.functionalIntegrity},
-            {"recovery_capacity", log.recoveryCapacity},
-            {"resilience_potential", log.resiliencePotential}
-        });
+// Per-step lines printed at the default log level
+constexpr size_t STEPS_ECHOED = 20;
+
+// Opens the results file, creating its directory when needed
+std::unique_ptr<InferenceResultSink> openResults(const std::string& path) {
+    const auto directory = std::filesystem::path(path).parent_path();
+    if (!directory.empty()) {
+        std::filesystem::create_directories(directory);
     }
-    j["history"] = entries;
-    std::ofstream o(filename);
-    o << j.dump(4);
+    return openResultSink(path);
 }
 
-int main() {
-    std::cout << "=== Ecofunctional Perceptron Experiment v0.2.1 (CSV Pipeline) ===\n" << std::endl;
+// Scores every plot of a multi-plot file concurrently, streams every step to
+// 'resultsPath' and prints the final state per plot
+void runFleet(const Perceptron& model, const std::string& fleetPath, const std::string& resultsPath,
+              size_t threads) {
+    auto plots = DataLoader::loadFleet(fleetPath, threads);
+
+    std::cout << "\n--> Running Fleet Inference on " << plots.size() << " plots..." << std::endl;
+    auto sink = openResults(resultsPath);
+    FleetInferenceEngine engine(threads);
+    auto summaries = engine.run(model, plots, *sink);
+    sink->close();
+
+    for (const auto& plot : summaries) {
+        if (plot.steps == 0) continue;
+        printResult(plot.plotId + " @ step " + std::to_string(plot.steps), plot.last);
+    }
+    std::cout << "\n" << sink->rowsWritten() << " steps saved to '" << resultsPath << "'." << std::endl;
+}
+
+// Cross-validates every grid configuration and prints them best first
+void runSweep(const EcofunctionalExperiment& experiment, const SweepGrid& grid, FeatureMatrixCache* featureCache) {
+    HyperparameterSweep sweep(0, featureCache);
+    auto results = sweep.run(experiment, grid);
+
+    std::cout << "\n--> Sweep results (" << grid.folds << "-fold validation MSE, best first)" << std::endl;
+    for (const auto& result : results) {
+        std::cout << "  lr=" << result.learningRate
+                  << " epochs=" << result.epochs
+                  << " window=" << (result.windowSize > 0 ? std::to_string(result.windowSize) : "pipeline")
+                  << " -> MSE " << result.meanValidationMse << " +/- " << result.stdValidationMse << std::endl;
+    }
+}
+
+// Command line: every data file may be a CSV or a binary columnar (.ecol) file
+struct RunOptions {
+    std::string trainingPath = "data/training_data.csv";
+    std::string trajectoryPath = "data/trajectory_data.csv";
+    std::string fleetPath; // --fleet scores a multi-plot file instead of the single trajectory
+    std::string featureCacheDir; // --feature-cache persists engineered features there between runs
+    std::string resultsPath;   // --results: NDJSON, or binary for *.ecores (default per mode below)
+    std::string modelPath;     // --model loads a saved model instead of training
+    std::string saveModelPath; // --save-model writes the trained model (binary for *.ecomodel, JSON otherwise)
+    TrainingOptions training;  // --epochs caps training; --tolerance/--patience enable early stopping
+    // --threads: CSV parsing and fleet scoring (0 = all hardware threads). CSVs
+    // are only split in chunks of 1 MiB or more, so small files parse on one thread.
+    size_t threads = 0;
+
+    bool profile = false;  // --profile prints per-stage timings at exit
+    std::string tracePath; // --trace writes a Chrome trace of the timed stages
+    LogLevel logLevel = LogLevel::INFO; // --log-level error|warn|info|debug; debug echoes every step
+
+    // Any --sweep-* or --folds argument runs a cross-validated hyperparameter sweep instead
+    bool sweep = false;
+    SweepGrid grid;
+};
+
+// Parses a comma-separated list such as "0.05,0.1,0.2"
+template <typename T>
+std::vector<T> parseList(const std::string& text) {
+    std::vector<T> values;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        values.push_back(static_cast<T>(std::stod(item)));
+    }
+    if (values.empty()) {
+        throw std::invalid_argument("Empty list: " + text);
+    }
+    return values;
+}
+
+RunOptions parseArgs(int argc, char* argv[]) {
+    RunOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--profile") {
+            options.profile = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            throw std::invalid_argument("Missing value for argument: " + arg);
+        }
+        if (arg == "--train") options.trainingPath = argv[++i];
+        else if (arg == "--trajectory") options.trajectoryPath = argv[++i];
+        else if (arg == "--fleet") options.fleetPath = argv[++i];
+        else if (arg == "--feature-cache") options.featureCacheDir = argv[++i];
+        else if (arg == "--threads") options.threads = std::stoul(argv[++i]);
+        else if (arg == "--trace") options.tracePath = argv[++i];
+        else if (arg == "--log-level") options.logLevel = parseLogLevel(argv[++i]);
+        else if (arg == "--results") options.resultsPath = argv[++i];
+        else if (arg == "--model") options.modelPath = argv[++i];
+        else if (arg == "--save-model") options.saveModelPath = argv[++i];
+        else if (arg == "--epochs") options.training.epochs = std::stoi(argv[++i]);
+        else if (arg == "--tolerance") options.training.tolerance = std::stof(argv[++i]);
+        else if (arg == "--patience") options.training.patience = std::stoi(argv[++i]);
+        else if (arg == "--sweep-lr") { options.grid.learningRates = parseList<float>(argv[++i]); options.sweep = true; }
+        else if (arg == "--sweep-epochs") { options.grid.epochs = parseList<int>(argv[++i]); options.sweep = true; }
+        else if (arg == "--sweep-window") { options.grid.windowSizes = parseList<int>(argv[++i]); options.sweep = true; }
+        else if (arg == "--folds") { options.grid.folds = std::stoul(argv[++i]); options.sweep = true; }
+        else throw std::invalid_argument("Unknown argument: " + arg);
+    }
+    return options;
+}
+
+int runPipeline(const RunOptions& options) {
+    Perceptron model;
+    if (!options.modelPath.empty() && !options.sweep) {
+        // A saved model skips loading the training data altogether
+        model.load(options.modelPath);
+        ECO_LOG_INFO("[Model] Loaded " << options.modelPath);
+    } else {
+        // 1. Load Training Data
+        auto experiment = DataLoader::loadExperiment(options.trainingPath, "EXP-CSV-01", options.threads);
+
+        std::unique_ptr<FeatureMatrixCache> featureCache;
+        if (!options.featureCacheDir.empty()) {
+            featureCache = std::make_unique<FeatureMatrixCache>(options.featureCacheDir);
+        }
+
+        if (options.sweep) {
+            runSweep(experiment, options.grid, featureCache.get());
+            return 0;
+        }
 
-    // 1. Load Training Data
-    auto experiment = DataLoader::loadExperimentFromCSV("data/training_data.csv", "EXP-CSV-01");
+        // 2. Train Model
+        PerceptronTrainingService trainer(featureCache.get());
+        trainer.trainFullExperiment(model, experiment, options.training);
+    }
+    if (!options.saveModelPath.empty()) {
+        model.save(options.saveModelPath);
+        ECO_LOG_INFO("[Model] Saved " << options.saveModelPath);
+    }
 
-    // 2. Train Model
-    Perceptron model(ECOFEATURE_VECTOR_SIZE);
-    PerceptronTrainingService trainer;
-    trainer.trainFullExperiment(model, experiment, 0.1f, 2000);
+    if (!options.fleetPath.empty()) {
+        runFleet(model, options.fleetPath,
+                 options.resultsPath.empty() ? "outputs/fleet_results.ndjson" : options.resultsPath,
+                 options.threads);
+        return 0;
+    }
 
     // 3. Load Trajectory for Inference
-    auto trajectory = DataLoader::loadTrajectoryFromCSV("data/trajectory_data.csv");
+    auto trajectory = DataLoader::loadTrajectory(options.trajectoryPath, options.threads);
 
     // 4. Run Sequential Inference (Piecewise Analysis)
     // To visualize hysteresis, we evaluate the trajectory step-by-step
     PerceptronInferenceService inferenceService;
-    std::vector<InferenceOutput> resultsLog;
 
     std::cout << "\n--> Running Sequential Inference on Trajectory..." << std::endl;
     
-    // Create growing sub-trajectories to simulate time passing
-    EcofunctionalTrajectory simulationTraj;
-    for (const auto& sample : trajectory.history) {
-        simulationTraj.addSample(sample);
-        
-        auto res = inferenceService.inferState(model, simulationTraj);
-        resultsLog.push_back(res);
-        
-        std::cout << "Step " << simulationTraj.history.size() 
-                  << ": Integrity=" << res.functionalIntegrity 
-                  << ", Recovery=" << res.recoveryCapacity << std::endl;
+    // 5. Stream Results for Visualization
+    // Replay walks the history once, as if each sample arrived in turn; steps are written in chunks as they are produced
+    const std::string resultsPath = options.resultsPath.empty() ? "outputs/inference_results.ndjson"
+                                                                : options.resultsPath;
+    auto sink = openResults(resultsPath);
+    std::vector<InferenceOutput> chunk;
+    size_t chunkStart = 0;
+    inferenceService.replay(model, trajectory, [&](size_t step, const InferenceOutput& res) {
+        // Long trajectories only echo their first steps unless logging at debug level
+        ECO_LOG(step < STEPS_ECHOED ? LogLevel::INFO : LogLevel::DEBUG,
+                "Step " << step + 1 << ": Integrity=" << res.functionalIntegrity
+                        << ", Recovery=" << res.recoveryCapacity);
+        chunk.push_back(res);
+        if (chunk.size() == FLEET_SINK_CHUNK) {
+            sink->write("", chunkStart, chunk.data(), chunk.size());
+            chunkStart = step + 1;
+            chunk.clear();
+        }
+    });
+    if (!chunk.empty()) {
+        sink->write("", chunkStart, chunk.data(), chunk.size());
     }
-
-    // 5. Save Results for Visualization
-    std::filesystem::create_directories("outputs");
-    saveInferenceLog("outputs/inference_results.json", resultsLog);
-    std::cout << "\nResults saved to 'outputs/inference_results.json'. Run plotting script!" << std::endl;
+    sink->close();
+    if (trajectory.history.size() > STEPS_ECHOED && !logEnabled(LogLevel::DEBUG)) {
+        ECO_LOG_INFO("... " << trajectory.history.size() - STEPS_ECHOED << " more steps (--log-level debug prints all)");
+    }
+    std::cout << "\nResults saved to '" << resultsPath << "'. Run plotting script!" << std::endl;
 
     return 0;
 }
+
+int main(int argc, char* argv[]) {
+    std::ios::sync_with_stdio(false); // Buffered std::cout; log lines no longer flush one by one
+    std::cout << "=== Ecofunctional Perceptron Experiment v0.2.1 (CSV Pipeline) ===\n" << std::endl;
+
+    RunOptions options;
+    try {
+        options = parseArgs(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\nUsage: EcofunctionalPerceptron [--train <file>] [--trajectory <file>] [--fleet <file>] [--feature-cache <dir>]"
+                  << " [--results <file>] [--model <file>] [--save-model <file>] [--threads <n>]"
+                  << " [--epochs <n>] [--tolerance <loss>] [--patience <epochs>]"
+                  << " [--sweep-lr <list>] [--sweep-epochs <list>] [--sweep-window <list>] [--folds <k>]"
+                  << " [--log-level error|warn|info|debug] [--profile] [--trace <file.json>]" << std::endl;
+        return 1;
+    }
+    setLogLevel(options.logLevel);
+    instrumentation::enableTracing(!options.tracePath.empty());
+
+    const int status = runPipeline(options);
+
+    if (options.profile) {
+        instrumentation::writeSummary(std::cout);
+    }
+    if (!options.tracePath.empty()) {
+        instrumentation::writeChromeTrace(options.tracePath);
+        ECO_LOG_INFO("[Profile] Trace written to " << options.tracePath);
+    }
+    flushLog();
+    return status;
+}
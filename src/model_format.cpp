@@ -0,0 +1,88 @@
+#include "model_format.h"
+#include "checksum.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+void writeModelFile(const std::string& path, const float* weights, size_t inputSize, float bias) {
+    std::vector<float> payload(weights, weights + inputSize);
+    payload.push_back(bias);
+    const size_t payloadBytes = payload.size() * sizeof(float);
+
+    ModelFileHeader header{};
+    std::memcpy(header.magic, MODEL_MAGIC, sizeof(header.magic));
+    header.version = MODEL_FORMAT_VERSION;
+    header.inputSize = static_cast<uint32_t>(inputSize);
+    header.pipelineVersion = FEATURE_PIPELINE_VERSION;
+    header.payloadOffset = sizeof(ModelFileHeader);
+    header.checksum = fnv1a(FNV1A_OFFSET_BASIS, payload.data(), payloadBytes);
+
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary);
+        if (!out.is_open()) {
+            throw std::runtime_error("Cannot write model file: " + path);
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payloadBytes));
+        if (!out) {
+            throw std::runtime_error("Failed writing model file: " + path);
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(tmpPath, path, error);
+    if (error) {
+        std::remove(tmpPath.c_str());
+        throw std::runtime_error("Cannot write model file " + path + ": " + error.message());
+    }
+}
+
+void ModelFile::open(const std::string& path) {
+    header_ = nullptr;
+    payload_ = nullptr;
+    if (!file_.open(path)) {
+        throw std::runtime_error("Cannot open model file: " + path);
+    }
+    if (file_.size() < sizeof(ModelFileHeader)) {
+        throw std::runtime_error("Model file too small: " + path);
+    }
+
+    const auto* header = reinterpret_cast<const ModelFileHeader*>(file_.data());
+    if (std::memcmp(header->magic, MODEL_MAGIC, sizeof(header->magic)) != 0) {
+        throw std::runtime_error("Not a model file: " + path);
+    }
+    if (header->version != MODEL_FORMAT_VERSION) {
+        throw std::runtime_error("Unsupported model format version " + std::to_string(header->version) + ": " + path);
+    }
+    if (header->inputSize != ECOFEATURE_VECTOR_SIZE) {
+        throw std::runtime_error("Model input size " + std::to_string(header->inputSize) +
+                                 " does not match feature vector size: " + path);
+    }
+    if (header->pipelineVersion != FEATURE_PIPELINE_VERSION) {
+        throw std::runtime_error("Model was trained with feature pipeline v" +
+                                 std::to_string(header->pipelineVersion) + ": " + path);
+    }
+
+    const size_t payloadBytes = (static_cast<size_t>(header->inputSize) + 1) * sizeof(float);
+    if (header->payloadOffset % alignof(float) != 0 ||
+        header->payloadOffset < sizeof(ModelFileHeader) ||
+        header->payloadOffset + payloadBytes > file_.size()) {
+        throw std::runtime_error("Model payload out of bounds: " + path);
+    }
+    const char* payload = file_.data() + header->payloadOffset;
+    if (fnv1a(FNV1A_OFFSET_BASIS, payload, payloadBytes) != header->checksum) {
+        throw std::runtime_error("Model checksum mismatch: " + path);
+    }
+
+    header_ = header;
+    payload_ = reinterpret_cast<const float*>(payload);
+}
+
+bool isBinaryModelPath(const std::string& path) {
+    const std::string extension = ".ecomodel";
+    return path.size() >= extension.size() &&
+           path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+}
@@ -1,59 +1,400 @@
 #include "perceptron.h"
+#include "perceptron_kernels.h"
+#include "model_format.h"
+#include "instrumentation.h"
+#include "thread_pool.h"
+#include <atomic>
+#include <memory>
+#include <chrono>
 #include <cmath>
+#include <limits>
 #include <fstream>
 #include <nlohmann/json.hpp>
 #include <stdexcept>
+#include <algorithm>
 
 using json = nlohmann::json;
 
-Perceptron::Perceptron(size_t inputSize)
-    : weights_(inputSize, 0.0f), bias_(0.0f) {}
+Perceptron::Perceptron()
+    : bias_(0.0f) {}
 
 float Perceptron::sigmoid(float z) {
     return 1.0f / (1.0f + std::exp(-z));
 }
 
-float Perceptron::infer(const std::vector<float>& x) const {
-    if (x.size() != weights_.size()) {
-        throw std::invalid_argument("Input size does not match perceptron weights");
-    }
+float Perceptron::infer(const FeatureVector& x) const {
     float z = bias_;
     for (size_t i = 0; i < x.size(); ++i)
         z += weights_[i] * x[i];
     return sigmoid(z);
 }
 
-void Perceptron::train(const std::vector<std::vector<float>>& X,
-                       const std::vector<float>& y,
-                       float lr,
-                       int epochs) {
-    for (int e = 0; e < epochs; ++e) {
-        for (size_t i = 0; i < X.size(); ++i) {
-            float y_hat = infer(X[i]);
-            float error = y[i] - y_hat;
+void Perceptron::inferBatch(const FeatureVector* rows, size_t count, float* out) const {
+    kernels::scoreBatch(weights_, bias_, rows, count, out);
+}
+
+void Perceptron::inferBatchScalar(const FeatureVector* rows, size_t count, float* out) const {
+    kernels::scoreBatchScalar(weights_, bias_, rows, count, out);
+}
+
+std::vector<float> Perceptron::inferBatch(const std::vector<FeatureVector>& rows) const {
+    std::vector<float> out(rows.size());
+    inferBatch(rows.data(), rows.size(), out.data());
+    return out;
+}
+
+float Perceptron::meanSquaredError(const FeatureVector* X, const float* y, size_t count) const {
+    if (count == 0) return 0.0f;
+    std::vector<float> predictions(count);
+    kernels::scoreBatch(weights_, bias_, X, count, predictions.data());
+    double sum = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        const double error = y[i] - predictions[i];
+        sum += error * error;
+    }
+    return static_cast<float>(sum / count);
+}
+
+TrainingReport Perceptron::train(const std::vector<FeatureVector>& X,
+                                 const std::vector<float>& y,
+                                 float lr,
+                                 int epochs) {
+    TrainingOptions options;
+    options.learningRate = lr;
+    options.epochs = epochs;
+    return train(X, y, options);
+}
+
+TrainingReport Perceptron::train(const std::vector<FeatureVector>& X,
+                                 const std::vector<float>& y,
+                                 const TrainingOptions& options) {
+    if (X.size() != y.size()) {
+        throw std::invalid_argument("Feature and label counts differ");
+    }
+    return train(X.data(), y.data(), X.size(), options);
+}
+
+TrainingReport Perceptron::train(const FeatureVector* X, const float* y, size_t count,
+                                 const TrainingOptions& options) {
+    ECO_TIME_SCOPE("perceptron.train");
+    if (options.batchSize == 0) {
+        throw std::invalid_argument("Training batch size must be at least 1");
+    }
+    if (options.patience < 1) {
+        throw std::invalid_argument("Early stopping patience must be at least 1");
+    }
+
+    const bool validating = options.validation.count > 0;
+    const bool earlyStopping = validating || options.tolerance > 0.0f;
+
+    const bool parallel = options.threads > 1;
+    if (parallel && options.parallelMode == ParallelMode::HOGWILD) {
+        if (earlyStopping || options.onEpoch) {
+            throw std::invalid_argument("Early stopping and epoch callbacks are not supported in HOGWILD mode");
+        }
+        return trainHogwild(X, y, count, options);
+    }
+    if (parallel && options.batchSize == 1) {
+        throw std::invalid_argument("Synchronous parallel training requires batchSize > 1");
+    }
+
+    std::vector<float> predictions;
+    if (options.batchSize > 1) {
+        predictions.resize(std::min(options.batchSize, count));
+    }
+    std::unique_ptr<ThreadPool> pool;
+    if (parallel) {
+        pool = std::make_unique<ThreadPool>(options.threads);
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const auto started = Clock::now();
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+
+    TrainingReport report;
+    report.bestValidationLoss = nan;
+
+    // Best monitored loss so far; with a validation set the matching weights are kept
+    float bestLoss = std::numeric_limits<float>::infinity();
+    int epochsWithoutImprovement = 0;
+    FeatureVector bestWeights = weights_;
+    float bestBias = bias_;
+
+    for (int e = 0; e < options.epochs; ++e) {
+        const auto epochStart = Clock::now();
+
+        double squaredErrors;
+        if (pool) {
+            squaredErrors = trainEpochSynchronous(X, y, count, options.batchSize, options.learningRate, predictions, *pool);
+        } else if (options.batchSize == 1) {
+            squaredErrors = trainEpochSgd(X, y, count, options.learningRate);
+        } else {
+            squaredErrors = trainEpochMiniBatch(X, y, count, options.batchSize, options.learningRate, predictions);
+        }
+
+        const auto epochEnd = Clock::now();
+        report.epochsRun = e + 1;
+        report.finalLoss = count > 0 ? static_cast<float>(squaredErrors / count) : 0.0f;
+
+        float validationLoss = nan;
+        if (validating) {
+            validationLoss = meanSquaredError(options.validation.X, options.validation.y,
+                                              options.validation.count);
+        }
+
+        if (options.onEpoch) {
+            const double epochSeconds = std::chrono::duration<double>(epochEnd - epochStart).count();
+            TrainingEpochStats stats;
+            stats.epoch = e + 1;
+            stats.loss = report.finalLoss;
+            stats.validationLoss = validationLoss;
+            stats.wallSeconds = std::chrono::duration<double>(epochEnd - started).count();
+            stats.samplesPerSecond = epochSeconds > 0.0 ? count / epochSeconds : 0.0;
+            if (!options.onEpoch(stats)) {
+                report.stoppedEarly = true;
+                break;
+            }
+        }
 
-            for (size_t j = 0; j < weights_.size(); ++j)
-                weights_[j] += lr * error * X[i][j];
+        if (earlyStopping) {
+            const float monitored = validating ? validationLoss : report.finalLoss;
+            if (monitored < bestLoss - options.tolerance) {
+                bestLoss = monitored;
+                epochsWithoutImprovement = 0;
+                if (validating) {
+                    bestWeights = weights_;
+                    bestBias = bias_;
+                }
+            } else if (++epochsWithoutImprovement >= options.patience) {
+                report.stoppedEarly = true;
+                break;
+            }
+        }
+    }
 
-            bias_ += lr * error;
+    if (validating && report.epochsRun > 0) {
+        // Keep the model that generalized best, not the last one
+        if (bestLoss < std::numeric_limits<float>::infinity()) {
+            weights_ = bestWeights;
+            bias_ = bestBias;
         }
+        report.bestValidationLoss = bestLoss;
     }
+    report.wallSeconds = std::chrono::duration<double>(Clock::now() - started).count();
+    return report;
+}
+
+float Perceptron::update(const FeatureVector& x, float y, float lr) {
+    float y_hat = infer(x);
+    float error = y - y_hat;
+
+    for (size_t j = 0; j < weights_.size(); ++j)
+        weights_[j] += lr * error * x[j];
+
+    bias_ += lr * error;
+    return error;
+}
+
+double Perceptron::trainEpochSgd(const FeatureVector* X, const float* y, size_t count, float lr) {
+    double squaredErrors = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        float error = update(X[i], y[i], lr);
+        squaredErrors += static_cast<double>(error) * error;
+    }
+    return squaredErrors;
+}
+
+double Perceptron::trainEpochMiniBatch(const FeatureVector* X, const float* y, size_t count,
+                                       size_t batchSize, float lr, std::vector<float>& predictions) {
+    double squaredErrors = 0.0;
+    for (size_t start = 0; start < count; start += batchSize) {
+        const size_t n = std::min(batchSize, count - start);
+
+        // Predictions for the whole batch, then errors in place
+        kernels::scoreBatch(weights_, bias_, X + start, n, predictions.data());
+        float errorSum = 0.0f;
+        for (size_t i = 0; i < n; ++i) {
+            predictions[i] = y[start + i] - predictions[i];
+            errorSum += predictions[i];
+            squaredErrors += static_cast<double>(predictions[i]) * predictions[i];
+        }
+
+        FeatureVector gradient{};
+        kernels::accumulateGradient(X + start, predictions.data(), n, gradient);
+
+        const float step = lr / static_cast<float>(n);
+        for (size_t j = 0; j < weights_.size(); ++j)
+            weights_[j] += step * gradient[j];
+        bias_ += step * errorSum;
+    }
+    return squaredErrors;
+}
+
+double Perceptron::trainEpochSynchronous(const FeatureVector* X, const float* y, size_t count,
+                                         size_t batchSize, float lr, std::vector<float>& predictions,
+                                         ThreadPool& pool) {
+    const size_t shards = pool.size();
+    std::vector<FeatureVector> shardGradients(shards);
+    std::vector<float> shardErrorSums(shards);
+    std::vector<double> shardSquaredErrors(shards, 0.0);
+    double squaredErrors = 0.0;
+
+    for (size_t start = 0; start < count; start += batchSize) {
+        const size_t n = std::min(batchSize, count - start);
+        const size_t shardRows = (n + shards - 1) / shards;
+
+        // Every shard reads the same weights; only its own gradient slot is written
+        pool.parallelFor(shards, [&](size_t s) {
+            FeatureVector& gradient = shardGradients[s];
+            gradient.fill(0.0f);
+            shardErrorSums[s] = 0.0f;
+            shardSquaredErrors[s] = 0.0;
+
+            const size_t begin = std::min(n, s * shardRows);
+            const size_t end = std::min(n, begin + shardRows);
+            if (begin == end) return;
+
+            const size_t rows = end - begin;
+            float* errors = predictions.data() + begin;
+            kernels::scoreBatch(weights_, bias_, X + start + begin, rows, errors);
+            float errorSum = 0.0f;
+            double squared = 0.0;
+            for (size_t i = 0; i < rows; ++i) {
+                errors[i] = y[start + begin + i] - errors[i];
+                errorSum += errors[i];
+                squared += static_cast<double>(errors[i]) * errors[i];
+            }
+            kernels::accumulateGradient(X + start + begin, errors, rows, gradient);
+            shardErrorSums[s] = errorSum;
+            shardSquaredErrors[s] = squared;
+        });
+
+        // Fixed reduction order keeps the result independent of thread scheduling
+        FeatureVector gradient{};
+        float errorSum = 0.0f;
+        for (size_t s = 0; s < shards; ++s) {
+            for (size_t j = 0; j < gradient.size(); ++j)
+                gradient[j] += shardGradients[s][j];
+            errorSum += shardErrorSums[s];
+            squaredErrors += shardSquaredErrors[s];
+        }
+
+        const float step = lr / static_cast<float>(n);
+        for (size_t j = 0; j < weights_.size(); ++j)
+            weights_[j] += step * gradient[j];
+        bias_ += step * errorSum;
+    }
+    return squaredErrors;
+}
+
+TrainingReport Perceptron::trainHogwild(const FeatureVector* X, const float* y, size_t count,
+                                        const TrainingOptions& options) {
+    const auto started = std::chrono::steady_clock::now();
+    static_assert(std::atomic<float>::is_always_lock_free, "Hogwild training needs lock-free atomic floats");
+
+    // Shared parameters; relaxed loads/stores without read-modify-write, so
+    // concurrent updates may overwrite each other as in the Hogwild scheme.
+    std::vector<std::atomic<float>> shared(weights_.size() + 1);
+    for (size_t j = 0; j < weights_.size(); ++j)
+        shared[j].store(weights_[j], std::memory_order_relaxed);
+    std::atomic<float>& sharedBias = shared[weights_.size()];
+    sharedBias.store(bias_, std::memory_order_relaxed);
+
+    ThreadPool pool(options.threads);
+    const size_t shards = pool.size();
+    const size_t shardRows = (count + shards - 1) / shards;
+    const float lr = options.learningRate;
+
+    pool.parallelFor(shards, [&](size_t s) {
+        const size_t begin = std::min(count, s * shardRows);
+        const size_t end = std::min(count, begin + shardRows);
+        FeatureVector w{};
+
+        for (int e = 0; e < options.epochs; ++e) {
+            for (size_t i = begin; i < end; ++i) {
+                float z = sharedBias.load(std::memory_order_relaxed);
+                for (size_t j = 0; j < w.size(); ++j) {
+                    w[j] = shared[j].load(std::memory_order_relaxed);
+                    z += w[j] * X[i][j];
+                }
+                float error = y[i] - sigmoid(z);
+
+                for (size_t j = 0; j < w.size(); ++j)
+                    shared[j].store(w[j] + lr * error * X[i][j], std::memory_order_relaxed);
+                sharedBias.store(sharedBias.load(std::memory_order_relaxed) + lr * error,
+                                 std::memory_order_relaxed);
+            }
+        }
+    });
+
+    for (size_t j = 0; j < weights_.size(); ++j)
+        weights_[j] = shared[j].load(std::memory_order_relaxed);
+    bias_ = sharedBias.load(std::memory_order_relaxed);
+
+    // Per-epoch losses are not observable across racing shards; report the final fit
+    TrainingReport report;
+    report.epochsRun = options.epochs;
+    report.finalLoss = meanSquaredError(X, y, count);
+    report.bestValidationLoss = std::numeric_limits<float>::quiet_NaN();
+    report.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    return report;
 }
 
 void Perceptron::save(const std::string& path) const {
+    if (!isBinaryModelPath(path)) {
+        saveJson(path);
+        return;
+    }
+    writeModelFile(path, weights_.data(), weights_.size(), bias_);
+}
+
+void Perceptron::load(const std::string& path) {
+    if (!isBinaryModelPath(path)) {
+        loadJson(path);
+        return;
+    }
+    ModelFile file;
+    file.open(path);
+    load(file);
+}
+
+void Perceptron::load(const ModelFile& file) {
+    if (!file.isOpen()) {
+        throw std::runtime_error("Model file is not open");
+    }
+    std::copy(file.weights(), file.weights() + weights_.size(), weights_.begin());
+    bias_ = file.bias();
+}
+
+void Perceptron::saveJson(const std::string& path) const {
     json j;
     j["weights"] = weights_;
     j["bias"] = bias_;
+    j["pipeline_version"] = FEATURE_PIPELINE_VERSION;
 
     std::ofstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot write model file: " + path);
+    }
     file << j.dump(4);
 }
 
-void Perceptron::load(const std::string& path) {
+void Perceptron::loadJson(const std::string& path) {
     std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open model file: " + path);
+    }
     json j;
     file >> j;
 
-    weights_ = j["weights"].get<std::vector<float>>();
+    auto weights = j["weights"].get<std::vector<float>>();
+    if (weights.size() != weights_.size()) {
+        throw std::runtime_error("Model weight count does not match feature vector size: " + path);
+    }
+    // Older exports carry no version; they predate pipeline changes
+    if (j.value("pipeline_version", FEATURE_PIPELINE_VERSION) != FEATURE_PIPELINE_VERSION) {
+        throw std::runtime_error("Model was trained with another feature pipeline version: " + path);
+    }
+    std::copy(weights.begin(), weights.end(), weights_.begin());
     bias_ = j["bias"].get<float>();
 }
@@ -0,0 +1,379 @@
+#include "perceptron_kernels.h"
+#include <cmath>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(ECOPERCEPTRON_FORCE_SCALAR)
+#define ECO_HAS_AVX2_KERNEL 1
+#include <immintrin.h>
+#endif
+
+namespace kernels {
+
+void scoreBatchScalar(const FeatureVector& weights, float bias,
+                      const FeatureVector* rows, size_t count, float* out) {
+    for (size_t r = 0; r < count; ++r) {
+        const FeatureVector& x = rows[r];
+        float z = bias;
+        for (size_t i = 0; i < ECOFEATURE_VECTOR_SIZE; ++i)
+            z += weights[i] * x[i];
+        out[r] = 1.0f / (1.0f + std::exp(-z));
+    }
+}
+
+uint16_t floatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint32_t sign = bits & 0x80000000u;
+    bits ^= sign;
+
+    uint16_t half;
+    if (bits >= (127u + 16u) << 23) {
+        // Overflow to infinity; NaN stays a quiet NaN
+        half = (bits > 255u << 23) ? 0x7e00 : 0x7c00;
+    } else if (bits < 113u << 23) {
+        // Subnormal or zero: let the FPU round by adding 0.5f as a magic bias
+        const uint32_t magicBits = 126u << 23;
+        float magic, f;
+        std::memcpy(&magic, &magicBits, sizeof(magic));
+        std::memcpy(&f, &bits, sizeof(f));
+        f += magic;
+        std::memcpy(&bits, &f, sizeof(bits));
+        half = static_cast<uint16_t>(bits - magicBits);
+    } else {
+        const uint32_t mantissaOdd = (bits >> 13) & 1u;
+        bits += (static_cast<uint32_t>(15 - 127) << 23) + 0xfffu + mantissaOdd;
+        half = static_cast<uint16_t>(bits >> 13);
+    }
+    return static_cast<uint16_t>(half | (sign >> 16));
+}
+
+float halfToFloat(uint16_t value) {
+    const uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+    const uint32_t exponent = (value >> 10) & 0x1fu;
+    const uint32_t mantissa = value & 0x3ffu;
+
+    float result;
+    if (exponent == 0) {
+        result = std::ldexp(static_cast<float>(mantissa), -24);
+        return sign ? -result : result;
+    }
+    const uint32_t bits = (exponent == 0x1f)
+        ? sign | 0x7f800000u | (mantissa << 13)
+        : sign | ((exponent + 112u) << 23) | (mantissa << 13);
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+void scoreBatchInt8Scalar(const int8_t* weights, float weightScale, float bias,
+                          const int8_t* rows, size_t count, float* out) {
+    for (size_t r = 0; r < count; ++r) {
+        const int8_t* x = rows + r * QUANTIZED_ROW_WIDTH;
+        int32_t dot = 0;
+        for (size_t i = 0; i < QUANTIZED_ROW_WIDTH; ++i)
+            dot += static_cast<int32_t>(weights[i]) * x[i];
+        const float z = bias + weightScale * static_cast<float>(dot);
+        out[r] = 1.0f / (1.0f + std::exp(-z));
+    }
+}
+
+void scoreBatchFp16Scalar(const uint16_t* weights, float bias,
+                          const uint16_t* rows, size_t count, float* out) {
+    float w[QUANTIZED_ROW_WIDTH];
+    for (size_t i = 0; i < QUANTIZED_ROW_WIDTH; ++i)
+        w[i] = halfToFloat(weights[i]);
+
+    for (size_t r = 0; r < count; ++r) {
+        const uint16_t* x = rows + r * QUANTIZED_ROW_WIDTH;
+        float z = bias;
+        for (size_t i = 0; i < QUANTIZED_ROW_WIDTH; ++i)
+            z += w[i] * halfToFloat(x[i]);
+        out[r] = 1.0f / (1.0f + std::exp(-z));
+    }
+}
+
+#ifdef ECO_HAS_AVX2_KERNEL
+
+// The feature row is covered by full 8-lane loads at 0, 8, 16, ... and, when
+// the width is not a multiple of 8, one overlapping load ending at the last
+// feature whose already-covered weight lanes are zeroed (default 30-wide row:
+// loads at 0, 8, 16 and 22, two lanes zeroed). All sizes are compile-time
+// constants of the feature pipeline, so the loops below fully unroll.
+static_assert(ECOFEATURE_VECTOR_SIZE >= 8, "AVX2 kernel needs at least 8 features per row");
+constexpr size_t FULL_LOADS = ECOFEATURE_VECTOR_SIZE / 8;
+constexpr bool HAS_TAIL = ECOFEATURE_VECTOR_SIZE % 8 != 0;
+constexpr size_t ROW_LOADS = FULL_LOADS + (HAS_TAIL ? 1 : 0);
+constexpr size_t TAIL_OFFSET = ECOFEATURE_VECTOR_SIZE - 8;
+constexpr size_t TAIL_OVERLAP = FULL_LOADS * 8 - TAIL_OFFSET;
+
+#define ECO_AVX2 __attribute__((target("avx2,fma")))
+
+namespace {
+
+// Cephes-style single precision exp, accurate to a few ulp over the clamped range.
+ECO_AVX2 inline __m256 exp256(__m256 x) {
+    x = _mm256_min_ps(x, _mm256_set1_ps(88.3762626647949f));
+    x = _mm256_max_ps(x, _mm256_set1_ps(-88.3762626647949f));
+
+    __m256 fx = _mm256_fmadd_ps(x, _mm256_set1_ps(1.44269504088896341f), _mm256_set1_ps(0.5f));
+    fx = _mm256_floor_ps(fx);
+
+    x = _mm256_fnmadd_ps(fx, _mm256_set1_ps(0.693359375f), x);
+    x = _mm256_fnmadd_ps(fx, _mm256_set1_ps(-2.12194440e-4f), x);
+
+    __m256 y = _mm256_set1_ps(1.9875691500e-4f);
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(1.3981999507e-3f));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(8.3334519073e-3f));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(4.1665795894e-2f));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(1.6666665459e-1f));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(5.0000001201e-1f));
+    y = _mm256_fmadd_ps(y, _mm256_mul_ps(x, x), _mm256_add_ps(x, _mm256_set1_ps(1.0f)));
+
+    __m256i n = _mm256_cvttps_epi32(fx);
+    n = _mm256_slli_epi32(_mm256_add_epi32(n, _mm256_set1_epi32(127)), 23);
+    return _mm256_mul_ps(y, _mm256_castsi256_ps(n));
+}
+
+ECO_AVX2 inline __m256 sigmoid256(__m256 z) {
+    const __m256 one = _mm256_set1_ps(1.0f);
+    __m256 e = exp256(_mm256_sub_ps(_mm256_setzero_ps(), z));
+    return _mm256_div_ps(one, _mm256_add_ps(one, e));
+}
+
+struct WeightLanes {
+    __m256 w[ROW_LOADS];
+};
+
+ECO_AVX2 inline WeightLanes loadWeights(const FeatureVector& weights) {
+    WeightLanes lanes;
+    for (size_t l = 0; l < FULL_LOADS; ++l)
+        lanes.w[l] = _mm256_loadu_ps(weights.data() + 8 * l);
+    if (HAS_TAIL) {
+        alignas(32) float tail[8];
+        for (size_t i = 0; i < 8; ++i)
+            tail[i] = (i < TAIL_OVERLAP) ? 0.0f : weights[TAIL_OFFSET + i];
+        lanes.w[ROW_LOADS - 1] = _mm256_load_ps(tail);
+    }
+    return lanes;
+}
+
+// Per-lane partial products of one row; lanes still need a horizontal sum.
+ECO_AVX2 inline __m256 rowProducts(const WeightLanes& w, const FeatureVector& x) {
+    const float* p = x.data();
+    __m256 acc = _mm256_mul_ps(w.w[0], _mm256_loadu_ps(p));
+    for (size_t l = 1; l < FULL_LOADS; ++l)
+        acc = _mm256_fmadd_ps(w.w[l], _mm256_loadu_ps(p + 8 * l), acc);
+    if (HAS_TAIL)
+        acc = _mm256_fmadd_ps(w.w[ROW_LOADS - 1], _mm256_loadu_ps(p + TAIL_OFFSET), acc);
+    return acc;
+}
+
+// Reduces eight partial-product vectors to one vector holding the eight row sums.
+ECO_AVX2 inline __m256 transposeSum(__m256 a0, __m256 a1, __m256 a2, __m256 a3,
+                                    __m256 a4, __m256 a5, __m256 a6, __m256 a7) {
+    __m256 t0 = _mm256_hadd_ps(_mm256_hadd_ps(a0, a1), _mm256_hadd_ps(a2, a3));
+    __m256 t1 = _mm256_hadd_ps(_mm256_hadd_ps(a4, a5), _mm256_hadd_ps(a6, a7));
+    return _mm256_add_ps(_mm256_permute2f128_ps(t0, t1, 0x20),
+                         _mm256_permute2f128_ps(t0, t1, 0x31));
+}
+
+ECO_AVX2 void scoreBatchAvx2(const FeatureVector& weights, float bias,
+                             const FeatureVector* rows, size_t count, float* out) {
+    const WeightLanes w = loadWeights(weights);
+    const __m256 vbias = _mm256_set1_ps(bias);
+
+    size_t r = 0;
+    for (; r + 8 <= count; r += 8) {
+        const FeatureVector* x = rows + r;
+        __m256 z = transposeSum(rowProducts(w, x[0]), rowProducts(w, x[1]),
+                                rowProducts(w, x[2]), rowProducts(w, x[3]),
+                                rowProducts(w, x[4]), rowProducts(w, x[5]),
+                                rowProducts(w, x[6]), rowProducts(w, x[7]));
+        _mm256_storeu_ps(out + r, sigmoid256(_mm256_add_ps(z, vbias)));
+    }
+
+    if (r < count) {
+        // Remainder rows go through the same vector path with zero-filled lanes
+        __m256 a[8];
+        for (size_t i = 0; i < 8; ++i)
+            a[i] = (r + i < count) ? rowProducts(w, rows[r + i]) : _mm256_setzero_ps();
+        __m256 z = transposeSum(a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7]);
+        alignas(32) float tmp[8];
+        _mm256_store_ps(tmp, sigmoid256(_mm256_add_ps(z, vbias)));
+        for (size_t i = 0; r + i < count; ++i)
+            out[r + i] = tmp[i];
+    }
+}
+
+constexpr size_t INT8_LOADS = QUANTIZED_ROW_WIDTH / 32; // 32 int8 lanes per load
+
+// Eight int32 partial sums of one int8 row (32 lanes per load, widened to int16 pairs)
+ECO_AVX2 inline __m256 int8RowProducts(const __m256i wLo[INT8_LOADS], const __m256i wHi[INT8_LOADS],
+                                       const int8_t* x) {
+    __m256i sums = _mm256_setzero_si256();
+    for (size_t l = 0; l < INT8_LOADS; ++l) {
+        const __m256i row = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x) + l);
+        const __m256i lo = _mm256_cvtepi8_epi16(_mm256_castsi256_si128(row));
+        const __m256i hi = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(row, 1));
+        sums = _mm256_add_epi32(sums, _mm256_add_epi32(_mm256_madd_epi16(lo, wLo[l]),
+                                                       _mm256_madd_epi16(hi, wHi[l])));
+    }
+    // Each lane holds at most 4 * INT8_LOADS * 127 * 127, exact in float32
+    return _mm256_cvtepi32_ps(sums);
+}
+
+ECO_AVX2 void scoreBatchInt8Avx2(const int8_t* weights, float weightScale, float bias,
+                                 const int8_t* rows, size_t count, float* out) {
+    __m256i wLo[INT8_LOADS];
+    __m256i wHi[INT8_LOADS];
+    for (size_t l = 0; l < INT8_LOADS; ++l) {
+        const __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights) + l);
+        wLo[l] = _mm256_cvtepi8_epi16(_mm256_castsi256_si128(w));
+        wHi[l] = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(w, 1));
+    }
+    const __m256 vscale = _mm256_set1_ps(weightScale);
+    const __m256 vbias = _mm256_set1_ps(bias);
+
+    for (size_t r = 0; r < count; r += 8) {
+        const size_t n = (count - r < 8) ? count - r : 8;
+        __m256 a[8];
+        for (size_t i = 0; i < 8; ++i)
+            a[i] = (i < n) ? int8RowProducts(wLo, wHi, rows + (r + i) * QUANTIZED_ROW_WIDTH)
+                           : _mm256_setzero_ps();
+        const __m256 dot = transposeSum(a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7]);
+        const __m256 y = sigmoid256(_mm256_fmadd_ps(dot, vscale, vbias));
+        if (n == 8) {
+            _mm256_storeu_ps(out + r, y);
+        } else {
+            alignas(32) float tmp[8];
+            _mm256_store_ps(tmp, y);
+            for (size_t i = 0; i < n; ++i)
+                out[r + i] = tmp[i];
+        }
+    }
+}
+
+#define ECO_AVX2_F16C __attribute__((target("avx2,fma,f16c")))
+
+constexpr size_t FP16_LOADS = QUANTIZED_ROW_WIDTH / 8; // 8 half lanes per load
+
+ECO_AVX2_F16C inline __m256 fp16RowProducts(const __m256 w[FP16_LOADS], const uint16_t* x) {
+    const __m128i* p = reinterpret_cast<const __m128i*>(x);
+    __m256 acc = _mm256_mul_ps(w[0], _mm256_cvtph_ps(_mm_loadu_si128(p)));
+    for (size_t l = 1; l < FP16_LOADS; ++l)
+        acc = _mm256_fmadd_ps(w[l], _mm256_cvtph_ps(_mm_loadu_si128(p + l)), acc);
+    return acc;
+}
+
+ECO_AVX2_F16C void scoreBatchFp16Avx2(const uint16_t* weights, float bias,
+                                      const uint16_t* rows, size_t count, float* out) {
+    const __m128i* wp = reinterpret_cast<const __m128i*>(weights);
+    __m256 w[FP16_LOADS];
+    for (size_t l = 0; l < FP16_LOADS; ++l)
+        w[l] = _mm256_cvtph_ps(_mm_loadu_si128(wp + l));
+    const __m256 vbias = _mm256_set1_ps(bias);
+
+    for (size_t r = 0; r < count; r += 8) {
+        const size_t n = (count - r < 8) ? count - r : 8;
+        __m256 a[8];
+        for (size_t i = 0; i < 8; ++i)
+            a[i] = (i < n) ? fp16RowProducts(w, rows + (r + i) * QUANTIZED_ROW_WIDTH)
+                           : _mm256_setzero_ps();
+        const __m256 z = transposeSum(a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7]);
+        const __m256 y = sigmoid256(_mm256_add_ps(z, vbias));
+        if (n == 8) {
+            _mm256_storeu_ps(out + r, y);
+        } else {
+            alignas(32) float tmp[8];
+            _mm256_store_ps(tmp, y);
+            for (size_t i = 0; i < n; ++i)
+                out[r + i] = tmp[i];
+        }
+    }
+}
+
+#undef ECO_AVX2_F16C
+
+} // namespace
+
+#undef ECO_AVX2
+
+#endif // ECO_HAS_AVX2_KERNEL
+
+namespace {
+KernelIsa detectIsa() {
+#ifdef ECO_HAS_AVX2_KERNEL
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return KernelIsa::AVX2;
+    }
+#endif
+    return KernelIsa::SCALAR;
+}
+
+#ifdef ECO_HAS_AVX2_KERNEL
+// F16C shipped alongside AVX2 on every x86 part, but is checked separately
+bool hasF16c() {
+    static const bool supported = activeIsa() == KernelIsa::AVX2 && __builtin_cpu_supports("f16c");
+    return supported;
+}
+#endif
+} // namespace
+
+KernelIsa activeIsa() {
+    static const KernelIsa isa = detectIsa();
+    return isa;
+}
+
+const char* isaName(KernelIsa isa) {
+    switch (isa) {
+        case KernelIsa::AVX2: return "avx2";
+        case KernelIsa::SCALAR: return "scalar";
+    }
+    return "unknown";
+}
+
+void scoreBatch(const FeatureVector& weights, float bias,
+                const FeatureVector* rows, size_t count, float* out) {
+#ifdef ECO_HAS_AVX2_KERNEL
+    if (activeIsa() == KernelIsa::AVX2) {
+        scoreBatchAvx2(weights, bias, rows, count, out);
+        return;
+    }
+#endif
+    scoreBatchScalar(weights, bias, rows, count, out);
+}
+
+void accumulateGradient(const FeatureVector* rows, const float* errors, size_t count,
+                        FeatureVector& gradient) {
+    float* __restrict g = gradient.data();
+    for (size_t r = 0; r < count; ++r) {
+        const float* __restrict x = rows[r].data();
+        const float e = errors[r];
+        for (size_t j = 0; j < ECOFEATURE_VECTOR_SIZE; ++j)
+            g[j] += e * x[j];
+    }
+}
+
+void scoreBatchInt8(const int8_t* weights, float weightScale, float bias,
+                    const int8_t* rows, size_t count, float* out) {
+#ifdef ECO_HAS_AVX2_KERNEL
+    if (activeIsa() == KernelIsa::AVX2) {
+        scoreBatchInt8Avx2(weights, weightScale, bias, rows, count, out);
+        return;
+    }
+#endif
+    scoreBatchInt8Scalar(weights, weightScale, bias, rows, count, out);
+}
+
+void scoreBatchFp16(const uint16_t* weights, float bias,
+                    const uint16_t* rows, size_t count, float* out) {
+#ifdef ECO_HAS_AVX2_KERNEL
+    if (hasF16c()) {
+        scoreBatchFp16Avx2(weights, bias, rows, count, out);
+        return;
+    }
+#endif
+    scoreBatchFp16Scalar(weights, bias, rows, count, out);
+}
+
+} // namespace kernels
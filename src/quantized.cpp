@@ -0,0 +1,103 @@
+#include "quantized.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+constexpr float INT8_LIMIT = 127.0f;
+
+int8_t quantizeInt8(float value) {
+    const float q = std::nearbyint(value);
+    return static_cast<int8_t>(std::max(-INT8_LIMIT, std::min(INT8_LIMIT, q)));
+}
+
+} // namespace
+
+const char* quantizationModeName(QuantizationMode mode) {
+    switch (mode) {
+        case QuantizationMode::INT8: return "int8";
+        case QuantizationMode::FP16: return "fp16";
+    }
+    return "unknown";
+}
+
+QuantizedPerceptron QuantizedPerceptron::fromModel(const Perceptron& model, QuantizationMode mode,
+                                                   const FeatureVector* calibration,
+                                                   size_t calibrationCount) {
+    QuantizedPerceptron q;
+    q.mode_ = mode;
+    q.bias_ = model.bias();
+    const FeatureVector& weights = model.weights();
+
+    if (mode == QuantizationMode::FP16) {
+        for (size_t j = 0; j < ECOFEATURE_VECTOR_SIZE; ++j)
+            q.fp16Weights_[j] = kernels::floatToHalf(weights[j]);
+        return q;
+    }
+
+    if (calibration == nullptr || calibrationCount == 0) {
+        throw std::invalid_argument("Int8 quantization needs calibration rows");
+    }
+
+    // Per-feature range from the calibration rows
+    std::array<float, ECOFEATURE_VECTOR_SIZE> featureScale{};
+    for (size_t r = 0; r < calibrationCount; ++r) {
+        for (size_t j = 0; j < ECOFEATURE_VECTOR_SIZE; ++j)
+            featureScale[j] = std::max(featureScale[j], std::fabs(calibration[r][j]));
+    }
+
+    // Weights folded with the feature scales, then quantized with one shared scale
+    std::array<float, ECOFEATURE_VECTOR_SIZE> folded{};
+    float maxFolded = 0.0f;
+    for (size_t j = 0; j < ECOFEATURE_VECTOR_SIZE; ++j) {
+        // Constant-zero features carry no information; any scale works
+        featureScale[j] = featureScale[j] > 0.0f ? featureScale[j] / INT8_LIMIT : 1.0f;
+        q.inverseFeatureScale_[j] = 1.0f / featureScale[j];
+        folded[j] = weights[j] * featureScale[j];
+        maxFolded = std::max(maxFolded, std::fabs(folded[j]));
+    }
+    q.weightScale_ = maxFolded > 0.0f ? maxFolded / INT8_LIMIT : 1.0f;
+    for (size_t j = 0; j < ECOFEATURE_VECTOR_SIZE; ++j)
+        q.int8Weights_[j] = quantizeInt8(folded[j] / q.weightScale_);
+    return q;
+}
+
+QuantizedMatrix QuantizedPerceptron::quantize(const FeatureVector* rows, size_t count) const {
+    constexpr size_t width = kernels::QUANTIZED_ROW_WIDTH;
+    QuantizedMatrix matrix;
+    matrix.mode = mode_;
+    matrix.rows = count;
+
+    if (mode_ == QuantizationMode::FP16) {
+        matrix.fp16Data.assign(count * width, 0);
+        for (size_t r = 0; r < count; ++r) {
+            uint16_t* out = matrix.fp16Data.data() + r * width;
+            for (size_t j = 0; j < ECOFEATURE_VECTOR_SIZE; ++j)
+                out[j] = kernels::floatToHalf(rows[r][j]);
+        }
+    } else {
+        matrix.int8Data.assign(count * width, 0);
+        for (size_t r = 0; r < count; ++r) {
+            int8_t* out = matrix.int8Data.data() + r * width;
+            for (size_t j = 0; j < ECOFEATURE_VECTOR_SIZE; ++j)
+                out[j] = quantizeInt8(rows[r][j] * inverseFeatureScale_[j]);
+        }
+    }
+    return matrix;
+}
+
+void QuantizedPerceptron::scoreBatch(const QuantizedMatrix& rows, float* out) const {
+    if (rows.mode != mode_) {
+        throw std::invalid_argument("Quantized matrix was built for another quantization mode");
+    }
+    if (mode_ == QuantizationMode::FP16) {
+        kernels::scoreBatchFp16(fp16Weights_.data(), bias_, rows.fp16Data.data(), rows.rows, out);
+    } else {
+        kernels::scoreBatchInt8(int8Weights_.data(), weightScale_, bias_, rows.int8Data.data(), rows.rows, out);
+    }
+}
+
+void QuantizedPerceptron::inferBatch(const FeatureVector* rows, size_t count, float* out) const {
+    scoreBatch(quantize(rows, count), out);
+}
@@ -0,0 +1,215 @@
+#include "result_sink.h"
+#include "instrumentation.h"
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+// ==========================================
+// InferenceResultSink
+// ==========================================
+
+void InferenceResultSink::write(std::string_view plotId, size_t firstStep,
+                                const InferenceOutput* outputs, size_t count) {
+    ECO_TIME_SCOPE("results.write");
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (closed_) {
+        throw std::logic_error("Write to a closed result sink");
+    }
+    append(plotId, firstStep, outputs, count);
+    rows_ += count;
+    ECO_COUNT("results.rows", count);
+}
+
+void InferenceResultSink::close() {
+    ECO_TIME_SCOPE("results.write");
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (closed_) return;
+    closed_ = true;
+    finish();
+}
+
+size_t InferenceResultSink::rowsWritten() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return rows_;
+}
+
+// ==========================================
+// NdjsonResultSink
+// ==========================================
+
+namespace {
+
+void appendFloat(std::string& out, float value) {
+    // Shortest representation that reads back as the same float
+    char digits[32];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, result.ptr);
+}
+
+} // namespace
+
+void appendJsonString(std::string& out, std::string_view text) {
+    out += '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+            out += escaped;
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+void appendNdjsonResult(std::string& out, std::string_view plotId, size_t step, const InferenceOutput& output) {
+    out += '{';
+    if (!plotId.empty()) {
+        out += "\"plot_id\":";
+        appendJsonString(out, plotId);
+        out += ',';
+    }
+    out += "\"step\":";
+    char number[24];
+    auto result = std::to_chars(number, number + sizeof(number), step);
+    out.append(number, result.ptr);
+    out += ",\"functional_integrity\":";
+    appendFloat(out, output.functionalIntegrity);
+    out += ",\"recovery_capacity\":";
+    appendFloat(out, output.recoveryCapacity);
+    out += ",\"resilience_potential\":";
+    appendFloat(out, output.resiliencePotential);
+    out += "}\n";
+}
+
+NdjsonResultSink::NdjsonResultSink(const std::string& path, size_t bufferBytes)
+    : InferenceResultSink(bufferBytes), out_(path, std::ios::binary), path_(path) {
+    if (!out_.is_open()) {
+        throw std::runtime_error("Cannot create results file: " + path);
+    }
+    buffer_.reserve(bufferBytes_ + 256);
+}
+
+NdjsonResultSink::~NdjsonResultSink() {
+    try {
+        close();
+    } catch (...) {
+        // Destructors must not throw; call close() explicitly to observe errors
+    }
+}
+
+void NdjsonResultSink::append(std::string_view plotId, size_t firstStep,
+                              const InferenceOutput* outputs, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        appendNdjsonResult(buffer_, plotId, firstStep + i, outputs[i]);
+        if (buffer_.size() >= bufferBytes_) flushBuffer();
+    }
+}
+
+void NdjsonResultSink::flushBuffer() {
+    out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    buffer_.clear();
+    if (!out_) {
+        throw std::runtime_error("Failed writing results file: " + path_);
+    }
+}
+
+void NdjsonResultSink::finish() {
+    flushBuffer();
+    out_.close();
+}
+
+// ==========================================
+// BinaryResultSink
+// ==========================================
+
+BinaryResultSink::BinaryResultSink(const std::string& path, size_t bufferBytes)
+    : InferenceResultSink(bufferBytes), out_(path, std::ios::binary), path_(path) {
+    if (!out_.is_open()) {
+        throw std::runtime_error("Cannot create results file: " + path);
+    }
+    // Placeholder header, rewritten with the final counts by finish()
+    ResultFileHeader header{};
+    out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    buffer_.reserve(bufferBytes_ / sizeof(ResultRecord) + 1);
+}
+
+BinaryResultSink::~BinaryResultSink() {
+    try {
+        close();
+    } catch (...) {
+        // Destructors must not throw; call close() explicitly to observe errors
+    }
+}
+
+uint32_t BinaryResultSink::plotIndex(std::string_view plotId) {
+    auto it = plotIndices_.find(std::string(plotId));
+    if (it != plotIndices_.end()) return it->second;
+    const auto index = static_cast<uint32_t>(plotIds_.size());
+    plotIds_.emplace_back(plotId);
+    plotIndices_.emplace(plotIds_.back(), index);
+    return index;
+}
+
+void BinaryResultSink::append(std::string_view plotId, size_t firstStep,
+                              const InferenceOutput* outputs, size_t count) {
+    const uint32_t plot = plotIndex(plotId);
+    for (size_t i = 0; i < count; ++i) {
+        ResultRecord record;
+        record.step = static_cast<uint64_t>(firstStep + i);
+        record.plotIndex = plot;
+        record.functionalIntegrity = outputs[i].functionalIntegrity;
+        record.recoveryCapacity = outputs[i].recoveryCapacity;
+        record.resiliencePotential = outputs[i].resiliencePotential;
+        buffer_.push_back(record);
+
+        if (buffer_.size() * sizeof(ResultRecord) >= bufferBytes_) flushBuffer();
+    }
+}
+
+void BinaryResultSink::flushBuffer() {
+    out_.write(reinterpret_cast<const char*>(buffer_.data()),
+               static_cast<std::streamsize>(buffer_.size() * sizeof(ResultRecord)));
+    recordCount_ += buffer_.size();
+    buffer_.clear();
+    if (!out_) {
+        throw std::runtime_error("Failed writing results file: " + path_);
+    }
+}
+
+void BinaryResultSink::finish() {
+    flushBuffer();
+
+    ResultFileHeader header{};
+    std::memcpy(header.magic, RESULT_FILE_MAGIC, sizeof(header.magic));
+    header.version = RESULT_FILE_VERSION;
+    header.recordSize = sizeof(ResultRecord);
+    header.recordCount = recordCount_;
+    header.plotTableOffset = sizeof(ResultFileHeader) + recordCount_ * sizeof(ResultRecord);
+    header.plotCount = static_cast<uint32_t>(plotIds_.size());
+
+    for (const auto& plotId : plotIds_) {
+        const auto length = static_cast<uint32_t>(plotId.size());
+        out_.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        out_.write(plotId.data(), length);
+    }
+    out_.seekp(0);
+    out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out_.close();
+    if (!out_) {
+        throw std::runtime_error("Failed writing results file: " + path_);
+    }
+}
+
+std::unique_ptr<InferenceResultSink> openResultSink(const std::string& path) {
+    const std::string extension = ".ecores";
+    if (path.size() >= extension.size() &&
+        path.compare(path.size() - extension.size(), extension.size(), extension) == 0) {
+        return std::make_unique<BinaryResultSink>(path);
+    }
+    return std::make_unique<NdjsonResultSink>(path);
+}
@@ -1,60 +1,97 @@
 #include "services.h"
-#include <iostream>
+#include "feature_cache.h"
+#include "instrumentation.h"
+#include "logging.h"
 #include <stdexcept>
+#include <algorithm>
 
-namespace {
-std::vector<float> buildFeatureVector(const EcofunctionalTrajectory& trajectory) {
-    if (trajectory.history.empty()) return {};
-
-    EcofunctionalVector current = trajectory.history.back().inputVector;
-    EcofunctionalVector delta = trajectory.calculateDelta();
-    EcofunctionalVector avg = trajectory.calculateAverage(3);
-
-    std::vector<float> features;
-    auto vCurr = current.toVector();
-    auto vDelta = delta.toVector();
-    auto vAvg = avg.toVector();
-
-    features.reserve(vCurr.size() * 3);
-    features.insert(features.end(), vCurr.begin(), vCurr.end());
-    features.insert(features.end(), vDelta.begin(), vDelta.end());
-    features.insert(features.end(), vAvg.begin(), vAvg.end());
+std::vector<FeatureVector> buildFeatureMatrix(const EcofunctionalSampleStore& samples, int windowSize) {
+    ECO_TIME_SCOPE("features.build");
+    if (windowSize < 0) {
+        throw std::invalid_argument("Rolling window size must be positive (or 0 for the pipeline windows)");
+    }
+    const size_t n = samples.size();
+    ECO_COUNT("features.rows", n);
+    std::vector<FeatureVector> X(n);
 
-    return features;
+    // Column-wise pass per attribute, same per-lane arithmetic as EcofunctionalFeatureState::push
+    for (size_t c = 0; c < ECOVECTOR_SIZE; ++c) {
+        ActiveFeaturePipeline::buildColumn(samples.attribute(c), n, c, static_cast<size_t>(windowSize), X.data());
+    }
+    return X;
 }
-} // namespace
 
 // ==========================================
 // PerceptronTrainingService
 // ==========================================
 
-void PerceptronTrainingService::trainFullExperiment(Perceptron& model, 
-                                                    const EcofunctionalExperiment& experiment, 
-                                                    float learningRate, 
-                                                    int epochs) {
-    std::cout << "[Service] Starting training for Experiment: " << experiment.getId() << std::endl;
-    
-    std::vector<std::vector<float>> X;
-    std::vector<float> y;
-    EcofunctionalTrajectory trajectory;
+PerceptronTrainingService::PerceptronTrainingService(FeatureMatrixCache* featureCache)
+    : featureCache_(featureCache) {}
+
+TrainingReport PerceptronTrainingService::trainFullExperiment(Perceptron& model, 
+                                                              const EcofunctionalExperiment& experiment, 
+                                                              float learningRate, 
+                                                              int epochs) {
+    TrainingOptions options;
+    options.learningRate = learningRate;
+    options.epochs = epochs;
+    return trainFullExperiment(model, experiment, options);
+}
+
+TrainingReport PerceptronTrainingService::trainFullExperiment(Perceptron& model,
+                                                              const EcofunctionalExperiment& experiment,
+                                                              const TrainingOptions& options) {
+    ECO_TIME_SCOPE("train");
+    ECO_LOG_INFO("[Service] Starting training for Experiment: " << experiment.getId());
     
     const auto& samples = experiment.getSamples();
     if (samples.empty()) {
         throw std::runtime_error("No samples found in experiment for training");
     }
 
-    for (const auto& sample : samples) {
-        trajectory.addSample(sample);
-        auto features = buildFeatureVector(trajectory);
-        if (features.size() != ECOFEATURE_VECTOR_SIZE) {
-            throw std::runtime_error("Unexpected feature size during training");
-        }
-        X.push_back(std::move(features));
-        y.push_back(sample.targetLabel);
+    // Features straight from the sample columns (or the cache); labels are used in place
+    std::shared_ptr<const FeatureMatrix> X;
+    if (featureCache_) {
+        X = featureCache_->get(experiment);
+    } else {
+        X = std::make_shared<const FeatureMatrix>(buildFeatureMatrix(samples));
     }
-    
-    model.train(X, y, learningRate, epochs);
-    std::cout << "[Service] Training completed." << std::endl;
+    TrainingReport report = model.train(X->data(), samples.labels().data, X->size(), options);
+    ECO_COUNT("train.epochs", report.epochsRun);
+    ECO_LOG_INFO("[Service] Training completed after " << report.epochsRun << " epochs"
+                 << (report.stoppedEarly ? " (stopped early)" : "")
+                 << ", loss " << report.finalLoss << ".");
+    return report;
+}
+
+// ==========================================
+// PerceptronOnlineLearningService
+// ==========================================
+
+namespace {
+// Smoothing of recentLoss(): roughly the last hundred samples
+constexpr float ONLINE_LOSS_DECAY = 0.01f;
+// Steps replay scores before classifying and interpreting them together
+constexpr size_t REPLAY_BLOCK = 256;
+// Steps interpretScores handles per inner loop
+constexpr size_t INTERPRET_BLOCK = 64;
+} // namespace
+
+PerceptronOnlineLearningService::PerceptronOnlineLearningService(Perceptron& model, float learningRate)
+    : model_(model), learningRate_(learningRate) {}
+
+float PerceptronOnlineLearningService::observe(const EcofunctionalSample& sample) {
+    state_.push(sample.inputVector);
+    const float error = model_.update(state_.featureRow(), sample.targetLabel, learningRate_);
+    const float squared = error * error;
+    recentLoss_ = (samplesSeen_ == 0) ? squared
+                                      : recentLoss_ + ONLINE_LOSS_DECAY * (squared - recentLoss_);
+    samplesSeen_++;
+    return error;
+}
+
+void PerceptronOnlineLearningService::resetStream() {
+    state_ = EcofunctionalFeatureState{};
 }
 
 // ==========================================
@@ -65,12 +102,74 @@ void PerceptronTrainingService::trainFullExperiment(Perceptron& model,
 InferenceOutput PerceptronInferenceService::inferState(const Perceptron& model, 
                                                        const EcofunctionalTrajectory& trajectory) {
     if (trajectory.history.empty()) return {};
+    return inferFromFeatureState(model, trajectory.featureState);
+}
+
+std::vector<InferenceOutput> PerceptronInferenceService::replay(const Perceptron& model,
+                                                                const EcofunctionalTrajectory& trajectory) {
+    std::vector<InferenceOutput> outputs;
+    outputs.reserve(trajectory.history.size());
+
+    replay(model, trajectory, [&](size_t, const InferenceOutput& output) {
+        outputs.push_back(output);
+    });
+    return outputs;
+}
+
+void PerceptronInferenceService::replay(const Perceptron& model,
+                                        const EcofunctionalTrajectory& trajectory,
+                                        const std::function<void(size_t, const InferenceOutput&)>& onStep) {
+    // Per-step work (features, scoring, state analysis) is timed as a whole
+    ECO_TIME_SCOPE("infer.replay");
+    // Features and scores advance step by step (model.infer keeps the outputs
+    // bit-identical to inferState); state classification and interpretation run
+    // a block at a time through the branch-free batch forms.
+    float scores[REPLAY_BLOCK];
+    float vegetationTrends[REPLAY_BLOCK];
+    size_t steps[REPLAY_BLOCK];
+    EcofunctionalTrajectory::TrajectoryState states[REPLAY_BLOCK];
+    InferenceOutput outputs[REPLAY_BLOCK];
+
+    TrajectoryCursor cursor(trajectory);
+    size_t blockStart = 0;
+    while (true) {
+        size_t count = 0;
+        while (count < REPLAY_BLOCK && cursor.next()) {
+            const EcofunctionalFeatureState& state = cursor.featureState();
+            scores[count] = model.infer(state.featureRow());
+            vegetationTrends[count] = state.vegetationTrend;
+            steps[count] = state.steps;
+            count++;
+        }
+        if (count == 0) break;
+
+        EcofunctionalTrajectory::classifyStates(vegetationTrends, steps, count, states);
+        interpretScores(scores, states, vegetationTrends, count, outputs);
+        for (size_t i = 0; i < count; ++i) {
+            onStep(blockStart + i, outputs[i]);
+        }
+        blockStart += count;
+    }
+    ECO_COUNT("infer.steps", cursor.position());
+}
+
+InferenceOutput PerceptronInferenceService::inferFromFeatureState(const Perceptron& model,
+                                                                  const EcofunctionalFeatureState& featureState) {
+    if (featureState.steps == 0) return {};
     
     // FEATURE ENGINEERING STRATEGY
-    // Input Vector = [Current State (10)] + [Delta (10)] + [Avg3 (10)]
-    auto inputFeatures = buildFeatureVector(trajectory);
+    // Input Vector = ActiveFeaturePipeline row, e.g. [Current State (10)] + [Delta (10)] + [Avg3 (10)]
+    auto inputFeatures = featureState.featureRow();
     float rawOutput = model.infer(inputFeatures);
-    
+
+    // Analyze trajectory state
+    return interpretScore(rawOutput, EcofunctionalTrajectory::classifyState(featureState),
+                          featureState.vegetationTrend);
+}
+
+InferenceOutput PerceptronInferenceService::interpretScore(float rawOutput,
+                                                           EcofunctionalTrajectory::TrajectoryState state,
+                                                           float vegTrend) {
     InferenceOutput output;
     output.functionalIntegrity = rawOutput;
     
@@ -78,17 +177,13 @@ InferenceOutput PerceptronInferenceService::inferState(const Perceptron& model,
     // PHASE 3: Continuous Recovery & Hysteresis
     // =========================================================
     
-    // Analyze trajectory state
-    auto state = trajectory.analyzeState();
-    float vegTrend = trajectory.getVegetationTrend();
-    
     // Logic for Recovery Capacity (0.0 - 1.0)
     // 1. High Integrity + Stable = Climax (High Resilience)
     // 2. High Integrity + Positive Trend = Robust Recovery (Very High Resilience)
     // 3. Low Integrity + Positive Trend = Early Recovery (Medium Resilience)
     // 4. Negative Trend = Collapsing (Low Resilience)
     
-    if (rawOutput > 0.7f) {
+    if (rawOutput > HIGH_INTEGRITY_THRESHOLD) {
         if (state == EcofunctionalTrajectory::TrajectoryState::RECOVERING) {
             output.recoveryCapacity = 1.0f; // Robust, active recovery
         } else if (state == EcofunctionalTrajectory::TrajectoryState::STABLE) {
@@ -110,3 +205,34 @@ InferenceOutput PerceptronInferenceService::inferState(const Perceptron& model,
     
     return output;
 }
+
+void PerceptronInferenceService::interpretScores(const float* functionalIntegrity,
+                                                 const EcofunctionalTrajectory::TrajectoryState* states,
+                                                 const float* vegetationTrends, size_t count,
+                                                 InferenceOutput* out) {
+    using State = EcofunctionalTrajectory::TrajectoryState;
+    for (size_t begin = 0; begin < count; begin += INTERPRET_BLOCK) {
+        const size_t n = std::min(INTERPRET_BLOCK, count - begin);
+        // Both branches of interpretScore are computed and the right one selected.
+        // Capacities go to a plain array first: the interleaved InferenceOutput
+        // stores would keep this loop from vectorizing without AVX2.
+        float recoveryCapacity[INTERPRET_BLOCK];
+        for (size_t i = 0; i < n; ++i) {
+            const float rawOutput = functionalIntegrity[begin + i];
+            const bool recovering = states[begin + i] == State::RECOVERING;
+            const bool stable = states[begin + i] == State::STABLE;
+
+            float earlyRecovery = 0.5f + (vegetationTrends[begin + i] * 2.0f);
+            earlyRecovery = (earlyRecovery > 0.8f) ? 0.8f : earlyRecovery;
+            const float highIntegrity = recovering ? 1.0f : (stable ? 0.9f : 0.7f);
+            const float lowIntegrity = recovering ? earlyRecovery : 0.1f;
+            recoveryCapacity[i] = (rawOutput > HIGH_INTEGRITY_THRESHOLD) ? highIntegrity : lowIntegrity;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            InferenceOutput& output = out[begin + i];
+            output.functionalIntegrity = functionalIntegrity[begin + i];
+            output.recoveryCapacity = recoveryCapacity[i];
+            output.resiliencePotential = (output.functionalIntegrity + output.recoveryCapacity) / 2.0f;
+        }
+    }
+}
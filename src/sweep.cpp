@@ -0,0 +1,101 @@
+#include "sweep.h"
+#include "feature_cache.h"
+#include "services.h"
+#include "instrumentation.h"
+#include "logging.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+
+HyperparameterSweep::HyperparameterSweep(size_t threads, FeatureMatrixCache* featureCache)
+    : pool_(threads), featureCache_(featureCache) {}
+
+std::vector<SweepResult> HyperparameterSweep::run(const EcofunctionalExperiment& experiment, const SweepGrid& grid) {
+    const auto& samples = experiment.getSamples();
+    const size_t n = samples.size();
+    if (grid.folds < 2 || grid.folds > n) {
+        throw std::invalid_argument("Cross-validation needs 2 <= folds <= number of samples");
+    }
+    if (grid.learningRates.empty() || grid.epochs.empty() || grid.windowSizes.empty()) {
+        throw std::invalid_argument("Sweep grid has an empty dimension");
+    }
+
+    // One feature matrix per window size, shared read-only by every task
+    std::vector<std::shared_ptr<const FeatureMatrix>> matrices;
+    for (int window : grid.windowSizes) {
+        matrices.push_back(featureCache_ ? featureCache_->get(experiment, window)
+                                         : std::make_shared<const FeatureMatrix>(buildFeatureMatrix(samples, window)));
+    }
+    const float* labels = samples.labels().data;
+
+    std::vector<SweepResult> results;
+    std::vector<size_t> matrixOf;
+    for (size_t w = 0; w < grid.windowSizes.size(); ++w) {
+        for (float lr : grid.learningRates) {
+            for (int epochs : grid.epochs) {
+                results.push_back({lr, epochs, grid.windowSizes[w], 0.0f, 0.0f, std::vector<float>(grid.folds)});
+                matrixOf.push_back(w);
+            }
+        }
+    }
+
+    ECO_TIME_SCOPE("sweep");
+    ECO_LOG_INFO("[Sweep] Evaluating " << results.size() << " configurations x " << grid.folds
+                 << " folds on " << pool_.size() << " threads");
+
+    pool_.parallelFor(results.size() * grid.folds, [&](size_t task) {
+        SweepResult& result = results[task / grid.folds];
+        const size_t fold = task % grid.folds;
+        const FeatureMatrix& X = *matrices[matrixOf[task / grid.folds]];
+
+        const size_t begin = n * fold / grid.folds;
+        const size_t end = n * (fold + 1) / grid.folds;
+
+        // Train on [0, begin) and [end + purge, n). The first rows after the
+        // validation block have Delta/RollingMean features computed from
+        // validation samples, so they are left out. The training rows are
+        // gathered once, and one train() call runs every epoch over them.
+        const size_t purge = ActiveFeaturePipeline::lookback(static_cast<size_t>(result.windowSize));
+        const size_t resume = std::min(n, end + purge);
+        FeatureMatrix trainX;
+        std::vector<float> trainY;
+        trainX.reserve(begin + (n - resume));
+        trainY.reserve(trainX.capacity());
+        trainX.insert(trainX.end(), X.begin(), X.begin() + begin);
+        trainY.insert(trainY.end(), labels, labels + begin);
+        trainX.insert(trainX.end(), X.begin() + resume, X.end());
+        trainY.insert(trainY.end(), labels + resume, labels + n);
+
+        Perceptron model;
+        TrainingOptions options;
+        options.learningRate = result.learningRate;
+        options.epochs = result.epochs;
+        options.batchSize = grid.batchSize;
+        if (!trainX.empty()) model.train(trainX.data(), trainY.data(), trainX.size(), options);
+
+        std::vector<float> predictions(end - begin);
+        model.inferBatch(X.data() + begin, predictions.size(), predictions.data());
+        double squaredError = 0.0;
+        for (size_t i = 0; i < predictions.size(); ++i) {
+            double diff = predictions[i] - labels[begin + i];
+            squaredError += diff * diff;
+        }
+        result.foldMse[fold] = static_cast<float>(squaredError / predictions.size());
+    });
+
+    for (auto& result : results) {
+        double sum = 0.0;
+        for (float mse : result.foldMse) sum += mse;
+        double mean = sum / result.foldMse.size();
+        double variance = 0.0;
+        for (float mse : result.foldMse) variance += (mse - mean) * (mse - mean);
+        result.meanValidationMse = static_cast<float>(mean);
+        result.stdValidationMse = static_cast<float>(std::sqrt(variance / result.foldMse.size()));
+    }
+
+    std::stable_sort(results.begin(), results.end(), [](const SweepResult& a, const SweepResult& b) {
+        return a.meanValidationMse < b.meanValidationMse;
+    });
+    return results;
+}
@@ -0,0 +1,165 @@
+#include "synthetic_data.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+uint64_t splitmix64(uint64_t& x) {
+    uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+float clamp01(float v) {
+    return std::min(1.0f, std::max(0.0f, v));
+}
+
+} // namespace
+
+const char* ecosystemRegimeName(EcosystemRegime regime) {
+    switch (regime) {
+        case EcosystemRegime::STABLE: return "stable";
+        case EcosystemRegime::DEGRADING: return "degrading";
+        case EcosystemRegime::COLLAPSING: return "collapsing";
+        case EcosystemRegime::RECOVERING: return "recovering";
+    }
+    return "unknown";
+}
+
+// ==========================================
+// SyntheticRng
+// ==========================================
+
+SyntheticRng::SyntheticRng(uint64_t seed) {
+    for (uint64_t& s : state_) s = splitmix64(seed);
+}
+
+uint64_t SyntheticRng::nextU64() {
+    const uint64_t result = rotl(state_[1] * 5, 7) * 9;
+    const uint64_t t = state_[1] << 17;
+    state_[2] ^= state_[0];
+    state_[3] ^= state_[1];
+    state_[1] ^= state_[2];
+    state_[0] ^= state_[3];
+    state_[2] ^= t;
+    state_[3] = rotl(state_[3], 45);
+    return result;
+}
+
+float SyntheticRng::uniform() {
+    // Top 24 bits: every value exactly representable
+    return static_cast<float>(nextU64() >> 40) * (1.0f / 16777216.0f);
+}
+
+float SyntheticRng::normal(float stddev) {
+    if (hasSpare_) {
+        hasSpare_ = false;
+        return spareNormal_ * stddev;
+    }
+    const double u1 = (static_cast<double>(nextU64() >> 11) + 1.0) * (1.0 / 9007199254740992.0); // (0, 1]
+    const double u2 = static_cast<double>(nextU64() >> 11) * (1.0 / 9007199254740992.0);
+    const double radius = std::sqrt(-2.0 * std::log(u1));
+    const double angle = 6.283185307179586 * u2;
+    spareNormal_ = static_cast<float>(radius * std::sin(angle));
+    hasSpare_ = true;
+    return static_cast<float>(radius * std::cos(angle)) * stddev;
+}
+
+// ==========================================
+// SyntheticPlotGenerator
+// ==========================================
+
+SyntheticPlotGenerator::SyntheticPlotGenerator(uint64_t seed, size_t plotIndex)
+    : rng_(seed ^ (0xd1b54a32d192ed03ULL * (static_cast<uint64_t>(plotIndex) + 1))) {
+    potential_ = 0.55f + 0.4f * rng_.uniform();
+    resilience_ = 0.3f + 0.7f * rng_.uniform();
+    noise_ = 0.01f + 0.03f * rng_.uniform();
+
+    // Plots start spread over the regimes so short runs still cover all of them
+    const float draw = rng_.uniform();
+    regime_ = draw < 0.55f ? EcosystemRegime::STABLE
+            : draw < 0.75f ? EcosystemRegime::DEGRADING
+            : draw < 0.85f ? EcosystemRegime::COLLAPSING
+                           : EcosystemRegime::RECOVERING;
+    const float start = (regime_ == EcosystemRegime::RECOVERING || regime_ == EcosystemRegime::COLLAPSING)
+                            ? 0.15f + 0.35f * rng_.uniform()
+                            : 0.6f + 0.4f * rng_.uniform();
+    health_ = potential_ * start;
+    soil_ = health_;
+    vegetation_ = health_;
+    vigorLag_ = health_;
+}
+
+void SyntheticPlotGenerator::advanceRegime() {
+    const float u = rng_.uniform();
+    switch (regime_) {
+        case EcosystemRegime::STABLE:
+            if (u < 0.006f) regime_ = EcosystemRegime::DEGRADING;
+            break;
+        case EcosystemRegime::DEGRADING:
+            // Past a threshold degradation tips into collapse
+            if (health_ < 0.35f && u < 0.05f) regime_ = EcosystemRegime::COLLAPSING;
+            else if (u < 0.015f) regime_ = EcosystemRegime::RECOVERING;
+            else if (u < 0.03f) regime_ = EcosystemRegime::STABLE;
+            break;
+        case EcosystemRegime::COLLAPSING:
+            if (health_ < 0.1f || u < 0.01f * resilience_) regime_ = EcosystemRegime::RECOVERING;
+            break;
+        case EcosystemRegime::RECOVERING:
+            if (health_ >= potential_ - 0.05f) regime_ = EcosystemRegime::STABLE;
+            else if (u < 0.005f) regime_ = EcosystemRegime::DEGRADING;
+            break;
+    }
+}
+
+EcofunctionalSample SyntheticPlotGenerator::next() {
+    advanceRegime();
+
+    float drift = 0.0f;
+    switch (regime_) {
+        case EcosystemRegime::STABLE:     drift = 0.05f * (potential_ - health_); break;
+        case EcosystemRegime::DEGRADING:  drift = -0.004f - 0.004f * rng_.uniform(); break;
+        case EcosystemRegime::COLLAPSING: drift = -0.02f * (0.5f + health_); break;
+        case EcosystemRegime::RECOVERING: drift = 0.008f * resilience_ * (1.1f - health_); break;
+    }
+    health_ = clamp01(health_ + drift + rng_.normal(0.003f));
+
+    // Vegetation follows health within a few steps; soil is lost faster than it is rebuilt
+    vegetation_ += 0.3f * (health_ - vegetation_);
+    soil_ += (health_ < soil_ ? 0.03f : 0.005f) * (health_ - soil_);
+    vigorLag_ += 0.1f * (vegetation_ - vigorLag_);
+
+    const float v = vegetation_, s = soil_;
+    const float infiltration = 0.1f + 0.8f * s * (0.5f + 0.5f * v);
+    std::array<float, ECOVECTOR_SIZE> attributes = {
+        0.2f + 0.8f * s,                       // SoilDepth
+        0.8f - 0.6f * s,                       // SoilComp
+        infiltration,                          // SoilInfilt
+        0.2f + 0.4f * v + 0.2f * infiltration, // HydroFlux
+        0.9f - 0.8f * v * std::sqrt(s),        // ErosionRisk
+        v,                                     // VegCovEI
+        0.9f * v + 0.1f * s,                   // VegCovES
+        v * (0.7f + 0.3f * health_),           // VegVigorEI
+        vigorLag_,                             // VegVigorES
+        0.3f * s + 0.7f * v                    // PropPot
+    };
+    for (float& a : attributes) a = clamp01(a + rng_.normal(noise_));
+
+    EcofunctionalSample sample;
+    sample.inputVector = EcofunctionalVector::fromArray(attributes);
+    sample.targetLabel = clamp01(0.5f * health_ + 0.3f * s + 0.2f * v);
+    return sample;
+}
+
+std::string syntheticPlotId(size_t plotIndex) {
+    char id[32];
+    std::snprintf(id, sizeof(id), "PLOT-%06zu", plotIndex);
+    return id;
+}
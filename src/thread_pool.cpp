@@ -0,0 +1,158 @@
+#include "thread_pool.h"
+#include <algorithm>
+#include <exception>
+
+namespace {
+// Identifies the pool and deque of the calling worker thread, if any
+thread_local const ThreadPool* currentPool = nullptr;
+thread_local size_t currentWorker = 0;
+} // namespace
+
+ThreadPool::ThreadPool(size_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    queues_.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    workers_.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        workers_.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stopping_ = true;
+    }
+    sleepCv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+size_t ThreadPool::size() const {
+    return workers_.size();
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    size_t target = (currentPool == this)
+        ? currentWorker
+        : nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    {
+        // Counted under the sleep mutex so an idle worker cannot miss the wake-up
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        pending_.fetch_add(1, std::memory_order_relaxed);
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues_[target]->mutex);
+        queues_[target]->tasks.push_back(std::move(task));
+    }
+    sleepCv_.notify_one();
+}
+
+void ThreadPool::parallelFor(size_t shards, const std::function<void(size_t)>& fn) {
+    if (shards == 0) return;
+
+    // Owned jointly by the caller and every shard: the last shard may still be
+    // inside notify_one() when the caller wakes up and returns
+    struct Completion {
+        std::mutex mutex;
+        std::condition_variable cv;
+        size_t remaining = 0;
+        std::exception_ptr firstError;
+    };
+    auto done = std::make_shared<Completion>();
+    done->remaining = shards;
+
+    for (size_t s = 0; s < shards; ++s) {
+        submit([done, &fn, s] {
+            std::exception_ptr error;
+            try {
+                fn(s);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(done->mutex);
+            if (error && !done->firstError) done->firstError = error;
+            if (--done->remaining == 0) done->cv.notify_one();
+        });
+    }
+
+    // Help with queued work instead of sleeping, so a parallelFor issued from a
+    // worker keeps the pool moving. Once no task can be taken, every shard has
+    // been dequeued and is running elsewhere, so blocking is safe.
+    std::function<void()> task;
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(done->mutex);
+            if (done->remaining == 0) break;
+        }
+        if (!takeTask(task)) break;
+        pending_.fetch_sub(1, std::memory_order_relaxed);
+        task();
+        task = nullptr;
+    }
+
+    std::unique_lock<std::mutex> lock(done->mutex);
+    done->cv.wait(lock, [&] { return done->remaining == 0; });
+    if (done->firstError) std::rethrow_exception(done->firstError);
+}
+
+bool ThreadPool::takeTask(std::function<void()>& task) {
+    if (currentPool == this) {
+        return popLocal(currentWorker, task) || steal(currentWorker, task);
+    }
+    // Outside the pool: take the oldest task of any deque
+    for (auto& queue : queues_) {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        if (queue->tasks.empty()) continue;
+        task = std::move(queue->tasks.front());
+        queue->tasks.pop_front();
+        return true;
+    }
+    return false;
+}
+
+bool ThreadPool::popLocal(size_t index, std::function<void()>& task) {
+    WorkerQueue& queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) return false;
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::steal(size_t thief, std::function<void()>& task) {
+    for (size_t offset = 1; offset < queues_.size(); ++offset) {
+        WorkerQueue& victim = *queues_[(thief + offset) % queues_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.tasks.empty()) continue;
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    currentPool = this;
+    currentWorker = index;
+
+    for (;;) {
+        std::function<void()> task;
+        if (popLocal(index, task) || steal(index, task)) {
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        if (stopping_ && pending_.load(std::memory_order_relaxed) == 0) return;
+        sleepCv_.wait(lock, [this] {
+            return stopping_ || pending_.load(std::memory_order_relaxed) > 0;
+        });
+    }
+}
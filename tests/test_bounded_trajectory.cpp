@@ -0,0 +1,124 @@
+#include "domain.h"
+#include "test_harness.h"
+#include <cstring>
+
+// Bounded (ring) sample stores and trajectories against their unbounded counterparts
+
+namespace {
+
+EcofunctionalSample sampleAt(size_t step) {
+    std::array<float, ECOVECTOR_SIZE> values;
+    for (size_t c = 0; c < ECOVECTOR_SIZE; ++c) {
+        // Irregular values so trends change sign and all trajectory states occur
+        values[c] = 0.5f + 0.3f * static_cast<float>(((step * 37 + c * 11) % 23)) / 23.0f -
+                    0.001f * static_cast<float>(step % 200);
+    }
+    return {EcofunctionalVector::fromArray(values), static_cast<float>(step % 7) / 7.0f};
+}
+
+bool sameFeatures(const FeatureVector& a, const FeatureVector& b) {
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (!testing::sameValue(a[i], b[i])) return false;
+    }
+    return true;
+}
+
+bool sameVector(const EcofunctionalVector& a, const EcofunctionalVector& b) {
+    const auto x = a.toArray();
+    const auto y = b.toArray();
+    for (size_t c = 0; c < ECOVECTOR_SIZE; ++c) {
+        if (!testing::sameValue(x[c], y[c])) return false;
+    }
+    return true;
+}
+
+// The bounded store retains exactly the newest rows of the full store, in
+// order, through contiguous views as well as element access
+bool retainsTail(const EcofunctionalSampleStore& bounded, const EcofunctionalSampleStore& full) {
+    const size_t offset = full.size() - bounded.size();
+    for (size_t c = 0; c < ECOVECTOR_SIZE; ++c) {
+        const ColumnView window = bounded.attribute(c);
+        if (window.size != bounded.size() ||
+            std::memcmp(window.data, full.attribute(c).data + offset, window.size * sizeof(float)) != 0) {
+            return false;
+        }
+    }
+    if (std::memcmp(bounded.labels().data, full.labels().data + offset, bounded.size() * sizeof(float)) != 0) {
+        return false;
+    }
+    for (size_t i = 0; i < bounded.size(); ++i) {
+        if (!sameVector(bounded.vectorAt(i), full.vectorAt(offset + i)) ||
+            bounded[i].targetLabel != full[offset + i].targetLabel) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+TEST_CASE(ringWrapsAndMirrors) {
+    for (size_t capacity : {size_t{1}, size_t{2}, BOUNDED_HISTORY_CAPACITY, size_t{5}}) {
+        EcofunctionalSampleStore bounded = EcofunctionalSampleStore::bounded(capacity);
+        EcofunctionalSampleStore full;
+        CHECK(bounded.isBounded() && bounded.capacity() == capacity && bounded.empty());
+        CHECK(!full.isBounded() && full.capacity() == 0);
+
+        // Many times around the ring, checking every step
+        for (size_t step = 0; step < 10 * capacity + 3; ++step) {
+            bounded.push_back(sampleAt(step));
+            full.push_back(sampleAt(step));
+            CHECK(bounded.size() == std::min(step + 1, capacity));
+            CHECK(retainsTail(bounded, full));
+            CHECK(sameVector(bounded.back().inputVector, sampleAt(step).inputVector));
+        }
+    }
+}
+
+TEST_CASE(appendColumnsMatchesPushBack) {
+    std::array<std::vector<float>, ECOVECTOR_SIZE> columns;
+    std::vector<float> labels;
+    EcofunctionalSampleStore pushed = EcofunctionalSampleStore::bounded(4);
+    for (size_t step = 0; step < 11; ++step) {
+        const EcofunctionalSample sample = sampleAt(step);
+        const auto values = sample.inputVector.toArray();
+        for (size_t c = 0; c < ECOVECTOR_SIZE; ++c) columns[c].push_back(values[c]);
+        labels.push_back(sample.targetLabel);
+        pushed.push_back(sample);
+    }
+    std::array<const float*, ECOVECTOR_SIZE> pointers;
+    for (size_t c = 0; c < ECOVECTOR_SIZE; ++c) pointers[c] = columns[c].data();
+
+    // In two appends, the first shorter and the second longer than the ring
+    EcofunctionalSampleStore appended = EcofunctionalSampleStore::bounded(4);
+    appended.appendColumns(pointers, labels.data(), 3);
+    for (size_t c = 0; c < ECOVECTOR_SIZE; ++c) pointers[c] += 3;
+    appended.appendColumns(pointers, labels.data() + 3, 8);
+    CHECK(appended.size() == 4);
+    CHECK(retainsTail(appended, pushed));
+}
+
+TEST_CASE(boundedTrajectoryMatchesFull) {
+    EcofunctionalTrajectory bounded = EcofunctionalTrajectory::bounded();
+    EcofunctionalTrajectory full;
+    CHECK(bounded.history.capacity() == BOUNDED_HISTORY_CAPACITY);
+
+    for (size_t step = 0; step < 2000; ++step) {
+        bounded.addSample(sampleAt(step));
+        full.addSample(sampleAt(step));
+
+        CHECK(bounded.stepsSeen() == step + 1 && bounded.history.size() == std::min(step + 1, BOUNDED_HISTORY_CAPACITY));
+        CHECK(sameFeatures(bounded.featureState.featureRow(), full.featureState.featureRow()));
+        CHECK(testing::sameValue(bounded.getVegetationTrend(), full.getVegetationTrend()));
+        CHECK(testing::sameValue(bounded.getHydroTrend(), full.getHydroTrend()));
+        CHECK(bounded.analyzeState() == full.analyzeState());
+        CHECK(sameVector(bounded.calculateDelta(), full.calculateDelta()));
+        CHECK(sameVector(bounded.calculateAverage(static_cast<int>(BOUNDED_HISTORY_CAPACITY)),
+                         full.calculateAverage(static_cast<int>(BOUNDED_HISTORY_CAPACITY))));
+    }
+    CHECK(retainsTail(bounded.history, full.history));
+}
+
+int main() {
+    return testing::runAllTests();
+}
@@ -0,0 +1,109 @@
+#include "domain.h"
+#include "services.h"
+#include "test_harness.h"
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// classifyStates/interpretScores against classifyState/interpretScore on the
+// same inputs, including NaN and values exactly on every threshold
+
+namespace {
+
+using State = EcofunctionalTrajectory::TrajectoryState;
+
+const float NAN_F = std::numeric_limits<float>::quiet_NaN();
+const float INF_F = std::numeric_limits<float>::infinity();
+
+// Vegetation trends around the 0.01 stability and 0.05 recovery thresholds
+std::vector<float> trendInputs() {
+    std::vector<float> trends = {0.0f, -0.0f, 0.01f, -0.01f, 0.05f, -0.05f, 0.2f, -0.2f, 0.03f, -0.03f,
+                                 0.15f, 1.0f, -1.0f, NAN_F, -NAN_F, INF_F, -INF_F};
+    for (float threshold : {0.01f, 0.05f, -0.01f, -0.05f, 0.0f, 0.15f}) {
+        trends.push_back(std::nextafter(threshold, INF_F));
+        trends.push_back(std::nextafter(threshold, -INF_F));
+    }
+    return trends;
+}
+
+// Scores around the 0.7 recovery threshold
+std::vector<float> scoreInputs() {
+    return {0.0f, 0.5f, 0.7f, std::nextafter(0.7f, 1.0f), std::nextafter(0.7f, 0.0f), 1.0f, NAN_F, -NAN_F, INF_F};
+}
+
+} // namespace
+
+TEST_CASE(classifyStatesMatchesClassifyState) {
+    std::vector<float> trends;
+    std::vector<size_t> steps;
+    for (float trend : trendInputs()) {
+        for (size_t step : {size_t{0}, size_t{1}, size_t{2}, size_t{3}, size_t{1000}}) {
+            trends.push_back(trend);
+            steps.push_back(step);
+        }
+    }
+    // Longer than one internal block, so the block tail is exercised too
+    while (trends.size() < 200) {
+        trends.push_back(trends[trends.size() % 50]);
+        steps.push_back(steps[steps.size() % 50]);
+    }
+
+    std::vector<State> batched(trends.size());
+    EcofunctionalTrajectory::classifyStates(trends.data(), steps.data(), trends.size(), batched.data());
+    for (size_t i = 0; i < trends.size(); ++i) {
+        EcofunctionalFeatureState state;
+        state.steps = steps[i];
+        state.vegetationTrend = trends[i];
+        CHECK(batched[i] == EcofunctionalTrajectory::classifyState(state));
+    }
+}
+
+TEST_CASE(interpretScoresMatchesInterpretScore) {
+    std::vector<float> scores;
+    std::vector<State> states;
+    std::vector<float> trends;
+    for (float score : scoreInputs()) {
+        for (State state : {State::STABLE, State::RECOVERING, State::DEGRADING, State::COLLAPSING, State::UNKNOWN}) {
+            for (float trend : trendInputs()) {
+                scores.push_back(score);
+                states.push_back(state);
+                trends.push_back(trend);
+            }
+        }
+    }
+
+    std::vector<InferenceOutput> batched(scores.size());
+    PerceptronInferenceService::interpretScores(scores.data(), states.data(), trends.data(), scores.size(),
+                                                batched.data());
+    for (size_t i = 0; i < scores.size(); ++i) {
+        const InferenceOutput expected = PerceptronInferenceService::interpretScore(scores[i], states[i], trends[i]);
+        CHECK(testing::sameValue(batched[i].functionalIntegrity, expected.functionalIntegrity));
+        CHECK(testing::sameValue(batched[i].recoveryCapacity, expected.recoveryCapacity));
+        CHECK(testing::sameValue(batched[i].resiliencePotential, expected.resiliencePotential));
+    }
+}
+
+TEST_CASE(thresholdsClassifyAsDocumented) {
+    auto classify = [](float trend) {
+        EcofunctionalFeatureState state;
+        state.steps = 2;
+        state.vegetationTrend = trend;
+        return EcofunctionalTrajectory::classifyState(state);
+    };
+    CHECK(classify(0.0f) == State::STABLE);
+    CHECK(classify(0.01f) == State::STABLE);   // between the thresholds falls back to STABLE
+    CHECK(classify(-0.01f) == State::DEGRADING);
+    CHECK(classify(0.05f) == State::STABLE);   // strictly above 0.05 recovers
+    CHECK(classify(-0.05f) == State::DEGRADING);
+    CHECK(classify(0.06f) == State::RECOVERING);
+    CHECK(classify(-0.06f) == State::COLLAPSING);
+    CHECK(classify(NAN_F) == State::STABLE);
+
+    CHECK(PerceptronInferenceService::interpretScore(0.7f, State::STABLE, 0.0f).recoveryCapacity == 0.1f);
+    CHECK(PerceptronInferenceService::interpretScore(std::nextafter(0.7f, 1.0f), State::STABLE, 0.0f)
+              .recoveryCapacity == 0.9f);
+}
+
+int main() {
+    return testing::runAllTests();
+}
@@ -0,0 +1,171 @@
+#include "columnar_dataset.h"
+#include "test_harness.h"
+#include <cstring>
+#include <limits>
+
+// .ecol round trips (table writer, streaming writer, CSV conversion) and
+// rejection of damaged files
+
+namespace {
+
+// 'rows' rows with every optional column, distinct values per cell
+ColumnarTable sampleTable(size_t rows, bool withOptionalColumns) {
+    ColumnarTable table;
+    for (size_t r = 0; r < rows; ++r) {
+        for (size_t c = 0; c < ECOVECTOR_SIZE; ++c) table.attributes[c].push_back(static_cast<float>(r) + 0.1f * c);
+        if (withOptionalColumns) {
+            table.target.push_back(static_cast<float>(r % 100) / 100.0f);
+            table.plotIndex.push_back(static_cast<uint32_t>(r % 3));
+            table.timestamps.push_back(1700000000000LL + static_cast<int64_t>(r));
+        }
+    }
+    if (withOptionalColumns) table.plotIds = {"PLOT-A", "PLOT-B", "PLOT-C"};
+    return table;
+}
+
+bool matches(const ColumnarDataset& data, const ColumnarTable& table) {
+    if (data.rowCount() != table.rowCount()) return false;
+    for (size_t c = 0; c < ECOVECTOR_SIZE; ++c) {
+        if (std::memcmp(data.attribute(c), table.attributes[c].data(), table.rowCount() * sizeof(float)) != 0) {
+            return false;
+        }
+    }
+    if (data.hasTarget() != !table.target.empty() || data.hasPlotId() != !table.plotIndex.empty() ||
+        data.hasTimestamp() != !table.timestamps.empty()) {
+        return false;
+    }
+    if (data.hasTarget() && std::memcmp(data.target(), table.target.data(), table.target.size() * sizeof(float)) != 0) {
+        return false;
+    }
+    if (data.hasPlotId() &&
+        std::memcmp(data.plotIndex(), table.plotIndex.data(), table.plotIndex.size() * sizeof(uint32_t)) != 0) {
+        return false;
+    }
+    if (data.hasTimestamp() &&
+        std::memcmp(data.timestamps(), table.timestamps.data(), table.timestamps.size() * sizeof(int64_t)) != 0) {
+        return false;
+    }
+    return data.plotIds() == table.plotIds;
+}
+
+bool opens(const std::string& path) {
+    ColumnarDataset data;
+    try {
+        data.open(path);
+        return true;
+    } catch (const std::runtime_error&) {
+        return false;
+    }
+}
+
+} // namespace
+
+TEST_CASE(tableRoundTrip) {
+    for (bool optional : {false, true}) {
+        const ColumnarTable table = sampleTable(1000, optional);
+        testing::TempFile file("roundtrip.ecol");
+        writeColumnarFile(file.path(), table);
+
+        ColumnarDataset data;
+        data.open(file.path());
+        CHECK(matches(data, table));
+        for (size_t c = 0; c < ECOVECTOR_SIZE; ++c) {
+            CHECK(reinterpret_cast<uintptr_t>(data.attribute(c)) % COLUMNAR_ALIGNMENT == 0);
+        }
+    }
+}
+
+TEST_CASE(emptyTableRoundTrip) {
+    testing::TempFile file("empty.ecol");
+    writeColumnarFile(file.path(), ColumnarTable{});
+    ColumnarDataset data;
+    data.open(file.path());
+    CHECK(data.rowCount() == 0);
+}
+
+TEST_CASE(streamWriterMatchesTableWriter) {
+    // Several chunks plus a partial one
+    const size_t rows = 2 * COLUMNAR_STREAM_CHUNK_ROWS + 123;
+    const ColumnarTable table = sampleTable(rows, true);
+    testing::TempFile whole("whole.ecol");
+    testing::TempFile streamed("streamed.ecol");
+    writeColumnarFile(whole.path(), table);
+
+    ColumnarStreamWriter writer(streamed.path(), rows,
+                                COLUMNAR_HAS_TARGET | COLUMNAR_HAS_PLOT_ID | COLUMNAR_HAS_TIMESTAMP, table.plotIds);
+    for (size_t r = 0; r < rows; ++r) {
+        std::array<float, ECOVECTOR_SIZE> values;
+        for (size_t c = 0; c < ECOVECTOR_SIZE; ++c) values[c] = table.attributes[c][r];
+        writer.append(values, table.target[r], table.plotIndex[r], table.timestamps[r]);
+    }
+    CHECK_THROWS(writer.append({}, 0.0f, 0, 0)); // more rows than declared
+    writer.close();
+
+    CHECK(testing::readBytes(whole.path()) == testing::readBytes(streamed.path()));
+}
+
+TEST_CASE(streamWriterRejectsMissingRows) {
+    testing::TempFile file("short.ecol");
+    ColumnarStreamWriter writer(file.path(), 10, COLUMNAR_HAS_TARGET);
+    writer.append({}, 1.0f);
+    CHECK_THROWS(writer.close());
+}
+
+TEST_CASE(csvConversionRoundTrip) {
+    testing::TempFile csv("convert.csv");
+    testing::writeBytes(csv.path(),
+                        "Timestamp,PlotId,SoilDepth,SoilComp,SoilInfilt,HydroFlux,ErosionRisk,VegCovEI,VegCovES,"
+                        "VegVigorEI,VegVigorES,PropPot,FunctionalIntegrity\n"
+                        "100,A,1,2,3,4,5,6,7,8,9,10,0.5\n"
+                        "101,B,0.1,0.2,0.3,0.4,0.5,0.6,0.7,0.8,0.9,1.0,0.25\n"
+                        "102,A,1,2,3\n"); // dropped: too few columns
+    const ColumnarTable table = columnarTableFromCSV(csv.path());
+    CHECK(table.rowCount() == 2);
+    CHECK((table.plotIds == std::vector<std::string>{"A", "B"}));
+    CHECK((table.plotIndex == std::vector<uint32_t>{0, 1}));
+    CHECK((table.timestamps == std::vector<int64_t>{100, 101}));
+    CHECK(table.attributes[9][1] == 1.0f && table.target[1] == 0.25f);
+
+    testing::TempFile ecol("convert.ecol");
+    writeColumnarFile(ecol.path(), table);
+    ColumnarDataset data;
+    data.open(ecol.path());
+    CHECK(matches(data, table));
+}
+
+TEST_CASE(damagedFilesAreRejected) {
+    testing::TempFile file("damaged.ecol");
+    writeColumnarFile(file.path(), sampleTable(500, true));
+    const std::string good = testing::readBytes(file.path());
+    CHECK(opens(file.path()));
+
+    auto withBytes = [&](const std::string& bytes) {
+        testing::writeBytes(file.path(), bytes);
+        return opens(file.path());
+    };
+    auto patched = [&](size_t offset, const void* value, size_t size) {
+        std::string bytes = good;
+        std::memcpy(&bytes[offset], value, size);
+        return bytes;
+    };
+
+    CHECK(!withBytes(""));
+    CHECK(!withBytes(good.substr(0, sizeof(ColumnarHeader) - 1)));
+    CHECK(!withBytes(good.substr(0, good.size() / 2))); // truncated columns
+    CHECK(!withBytes(patched(0, "NOTECOL", 8)));
+
+    const uint32_t futureVersion = COLUMNAR_VERSION + 1;
+    CHECK(!withBytes(patched(offsetof(ColumnarHeader, version), &futureVersion, sizeof(futureVersion))));
+    const uint32_t attributeCount = ECOVECTOR_SIZE + 1;
+    CHECK(!withBytes(patched(offsetof(ColumnarHeader, attributeCount), &attributeCount, sizeof(attributeCount))));
+    const uint64_t misaligned = sizeof(ColumnarHeader) + 4;
+    CHECK(!withBytes(patched(offsetof(ColumnarHeader, attributeOffsets), &misaligned, sizeof(misaligned))));
+    const uint64_t hugeRowCount = std::numeric_limits<uint64_t>::max() / 2;
+    CHECK(!withBytes(patched(offsetof(ColumnarHeader, rowCount), &hugeRowCount, sizeof(hugeRowCount))));
+    const uint64_t hugeTable = good.size();
+    CHECK(!withBytes(patched(offsetof(ColumnarHeader, plotTableSize), &hugeTable, sizeof(hugeTable))));
+}
+
+int main() {
+    return testing::runAllTests();
+}
@@ -0,0 +1,115 @@
+#include "csv_reader.h"
+#include "test_harness.h"
+#include <string>
+#include <vector>
+
+// The from_chars CSV primitives against the std::getline / std::stof
+// behaviour of the original loaders, and the diagnostics they produce
+
+namespace {
+
+std::vector<std::string> lines(std::string_view buffer) {
+    CsvLineReader reader(buffer);
+    std::vector<std::string> out;
+    std::string_view line;
+    while (reader.next(line)) out.emplace_back(line);
+    return out;
+}
+
+std::vector<std::string> fields(std::string_view line) {
+    CsvFieldReader reader(line);
+    std::vector<std::string> out;
+    std::string_view field;
+    while (reader.next(field)) out.emplace_back(field);
+    return out;
+}
+
+bool parses(std::string_view field, float expected) {
+    float value = -12345.0f;
+    return parseFloat(field, value) && testing::sameValue(value, expected);
+}
+
+bool rejects(std::string_view field) {
+    float value;
+    return !parseFloat(field, value);
+}
+
+} // namespace
+
+TEST_CASE(lineReaderMatchesGetline) {
+    CHECK((lines("a\nb\r\n\nc") == std::vector<std::string>{"a", "b", "", "c"}));
+    CHECK((lines("a\n") == std::vector<std::string>{"a"}));
+    CHECK(lines("").empty());
+
+    CsvLineReader reader("h\nx\ny", 1);
+    std::string_view line;
+    reader.next(line);
+    CHECK(reader.lineNumber() == 1);
+    CHECK(reader.offset() == 2);
+    reader.next(line);
+    reader.next(line);
+    CHECK(reader.lineNumber() == 3);
+    CHECK(!reader.next(line));
+}
+
+TEST_CASE(fieldReaderMatchesGetline) {
+    CHECK((fields("1,2,3") == std::vector<std::string>{"1", "2", "3"}));
+    CHECK((fields("1,,3") == std::vector<std::string>{"1", "", "3"}));
+    CHECK((fields("1,2,") == std::vector<std::string>{"1", "2"})); // no trailing empty field
+    CHECK(fields("").empty());
+}
+
+TEST_CASE(parseFloatMatchesStof) {
+    CHECK(parses("1.5", 1.5f));
+    CHECK(parses("-0.25", -0.25f));
+    CHECK(parses("  +3", 3.0f));
+    CHECK(parses("\t7e-1", 0.7f));
+    CHECK(parses("0.1", 0.1f)); // correctly rounded
+    CHECK(parses("2.5abc", 2.5f)); // numeric prefix, as std::stof
+    CHECK(parses("1.0\r", 1.0f));
+    CHECK(rejects(""));
+    CHECK(rejects("   "));
+    CHECK(rejects("abc"));
+    CHECK(rejects("+"));
+    CHECK(rejects("+-1"));
+    CHECK(rejects("1e999")); // out of range
+}
+
+TEST_CASE(invalidFieldsProduceDiagnostics) {
+    CsvFieldReader reader("1.0,bad,3.0,,5.0,6.0");
+    float values[4] = {};
+    std::vector<CsvDiagnostic> diagnostics;
+    const size_t count = parseFloatFields(reader, values, 4, diagnostics, 42);
+
+    CHECK(count == 4); // valid values are counted past the capacity
+    CHECK(values[0] == 1.0f && values[1] == 3.0f && values[2] == 5.0f && values[3] == 6.0f);
+    CHECK(diagnostics.size() == 2);
+    if (diagnostics.size() == 2) {
+        CHECK(diagnostics[0].line == 42);
+        CHECK(diagnostics[0].message == "Skipping invalid value 'bad'");
+        CHECK(diagnostics[1].message == "Skipping invalid value ''");
+    }
+}
+
+TEST_CASE(chunksAreNewlineAlignedAndComplete) {
+    std::string buffer;
+    for (int i = 0; i < 5000; ++i) buffer += "row" + std::to_string(i) + ",1,2,3\n";
+    buffer += "last,4,5,6"; // no final newline
+
+    const auto chunks = splitCsvChunks(buffer, 7, 1000);
+    CHECK(chunks.size() == 7);
+    std::string joined;
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        if (c + 1 < chunks.size()) CHECK(!chunks[c].empty() && chunks[c].back() == '\n');
+        joined.append(chunks[c]);
+    }
+    CHECK(joined == buffer);
+
+    // Below the minimum chunk size the buffer is not split
+    CHECK(splitCsvChunks(buffer, 7).size() == 1);
+    CHECK(splitCsvChunks("", 4).size() <= 1);
+}
+
+int main() {
+    return testing::runAllTests();
+}
@@ -0,0 +1,135 @@
+#include "csv_reader.h"
+#include "data_loader.h"
+#include "logging.h"
+#include "mapped_file.h"
+#include "test_harness.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Parallel (byte-range) and single-threaded CSV loading must agree on every
+// row and on the file line numbers of every diagnostic
+
+namespace {
+
+const std::string HEADER =
+    "SoilDepth,SoilComp,SoilInfilt,HydroFlux,ErosionRisk,VegCovEI,VegCovES,VegVigorEI,VegVigorES,PropPot";
+
+// Rows of 10 attributes (+ a target, or a leading plot id), large enough to
+// split into several 1 MiB chunks, with malformed and blank lines throughout
+std::string writeCsv(const std::string& name, bool withTarget, bool withPlotId, size_t rows) {
+    const auto path = std::filesystem::temp_directory_path() / name;
+    std::ofstream out(path, std::ios::binary);
+    out << (withPlotId ? "PlotId," : "") << HEADER << (withTarget ? ",FunctionalIntegrity\n" : "\n");
+    for (size_t r = 0; r < rows; ++r) {
+        if (r % 9973 == 17) {
+            out << "\n"; // blank line
+            continue;
+        }
+        if (withPlotId) out << "PLOT-" << r % 37 << ',';
+        if (r % 7919 == 5) {
+            out << "1.0,2.0,oops\n"; // bad field and too few columns
+            continue;
+        }
+        for (size_t c = 0; c < 10; ++c) out << (c ? "," : "") << (r * 10 + c) % 1000 * 0.001;
+        if (withTarget) out << ',' << r % 100 * 0.01;
+        out << '\n';
+    }
+    return path.string();
+}
+
+// Runs 'load' with warnings captured, returning them
+template <typename Fn>
+std::string captureWarnings(Fn&& load) {
+    std::ostringstream captured;
+    std::streambuf* previousErr = std::cerr.rdbuf(captured.rdbuf());
+    std::streambuf* previousOut = std::cout.rdbuf(nullptr);
+    try {
+        load();
+    } catch (...) {
+        std::cerr.rdbuf(previousErr);
+        std::cout.rdbuf(previousOut);
+        throw;
+    }
+    flushLog();
+    std::cerr.rdbuf(previousErr);
+    std::cout.rdbuf(previousOut);
+    return captured.str();
+}
+
+bool splitsIntoChunks(const std::string& path) {
+    MappedFile file;
+    return file.open(path) && splitCsvChunks(file.view(), 4).size() > 1;
+}
+
+bool sameStore(const EcofunctionalSampleStore& a, const EcofunctionalSampleStore& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t c = 0; c < ECOVECTOR_SIZE; ++c) {
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (!testing::sameValue(a.attribute(c)[i], b.attribute(c)[i])) return false;
+        }
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (!testing::sameValue(a.labels()[i], b.labels()[i])) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+TEST_CASE(parallelExperimentMatchesSequential) {
+    const std::string path = writeCsv("ecoperceptron_test_experiment.csv", true, false, 120000);
+    CHECK(splitsIntoChunks(path));
+
+    EcofunctionalExperiment sequential("S"), parallel("P");
+    const std::string sequentialLog = captureWarnings([&] { sequential = DataLoader::loadExperiment(path, "S", 1); });
+    const std::string parallelLog = captureWarnings([&] { parallel = DataLoader::loadExperiment(path, "P", 4); });
+
+    CHECK(sequential.getSamples().size() > 100000);
+    CHECK(sameStore(sequential.getSamples(), parallel.getSamples()));
+    CHECK(!sequentialLog.empty());
+    CHECK(sequentialLog == parallelLog);
+    // Header is line 1; data row r is on line r + 2
+    CHECK(sequentialLog.find("(line 7)") != std::string::npos);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE(parallelTrajectoryMatchesSequential) {
+    const std::string path = writeCsv("ecoperceptron_test_trajectory.csv", false, false, 120000);
+    CHECK(splitsIntoChunks(path));
+
+    EcofunctionalTrajectory sequential, parallel;
+    const std::string sequentialLog = captureWarnings([&] { sequential = DataLoader::loadTrajectory(path, 1); });
+    const std::string parallelLog = captureWarnings([&] { parallel = DataLoader::loadTrajectory(path, 4); });
+
+    CHECK(sameStore(sequential.history, parallel.history));
+    CHECK(sequential.featureState.featureRow() == parallel.featureState.featureRow());
+    CHECK(!sequentialLog.empty());
+    CHECK(sequentialLog == parallelLog);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE(parallelFleetMatchesSequential) {
+    const std::string path = writeCsv("ecoperceptron_test_fleet.csv", false, true, 120000);
+    CHECK(splitsIntoChunks(path));
+
+    std::vector<PlotTrajectory> sequential, parallel;
+    const std::string sequentialLog = captureWarnings([&] { sequential = DataLoader::loadFleet(path, 1); });
+    const std::string parallelLog = captureWarnings([&] { parallel = DataLoader::loadFleet(path, 4); });
+
+    CHECK(sequential.size() == 37);
+    CHECK(sequential.size() == parallel.size());
+    for (size_t p = 0; p < std::min(sequential.size(), parallel.size()); ++p) {
+        CHECK(sequential[p].plotId == parallel[p].plotId);
+        CHECK(sameStore(sequential[p].trajectory.history, parallel[p].trajectory.history));
+    }
+    CHECK(!sequentialLog.empty());
+    CHECK(sequentialLog == parallelLog);
+    std::filesystem::remove(path);
+}
+
+int main() {
+    return testing::runAllTests();
+}
@@ -0,0 +1,143 @@
+#include "feature_cache.h"
+#include "logging.h"
+#include "services.h"
+#include "test_harness.h"
+#include "thread_pool.h"
+#include <cstring>
+#include <filesystem>
+
+// Persisted .features files: reload on a fresh cache, and rebuild when the
+// file is stale or damaged
+
+namespace {
+
+EcofunctionalExperiment sampleExperiment(size_t rows) {
+    EcofunctionalExperiment experiment("EXP cache/test");
+    for (size_t r = 0; r < rows; ++r) {
+        std::array<float, ECOVECTOR_SIZE> values;
+        for (size_t c = 0; c < ECOVECTOR_SIZE; ++c) values[c] = 0.5f + 0.01f * static_cast<float>((r * 7 + c) % 40);
+        experiment.addSample({EcofunctionalVector::fromArray(values), static_cast<float>(r % 10) / 10.0f});
+    }
+    return experiment;
+}
+
+bool sameMatrix(const FeatureMatrix& a, const FeatureMatrix& b) {
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(FeatureVector)) == 0;
+}
+
+// Fresh persist directory per test, removed afterwards
+class TempDirectory {
+public:
+    explicit TempDirectory(const std::string& name)
+        : path_(std::filesystem::temp_directory_path() / ("ecoperceptron_test_" + name)) {
+        std::filesystem::remove_all(path_);
+        std::filesystem::create_directories(path_);
+    }
+    ~TempDirectory() {
+        std::error_code ignored;
+        std::filesystem::remove_all(path_, ignored);
+    }
+
+    std::string path() const { return path_.string(); }
+
+private:
+    std::filesystem::path path_;
+};
+
+} // namespace
+
+TEST_CASE(memoryCacheSharesMatrix) {
+    const EcofunctionalExperiment experiment = sampleExperiment(50);
+    FeatureMatrixCache cache;
+    auto first = cache.get(experiment);
+    auto second = cache.get(experiment);
+    CHECK(first == second);
+    CHECK(cache.hits() == 1 && cache.misses() == 1);
+    CHECK(sameMatrix(*first, buildFeatureMatrix(experiment.getSamples())));
+
+    // A different window is a different matrix
+    auto windowed = cache.get(experiment, 5);
+    CHECK(windowed != first && cache.misses() == 2);
+}
+
+TEST_CASE(concurrentRequestsShareOneBuild) {
+    TempDirectory directory("feature_cache_concurrent");
+    const EcofunctionalExperiment experiment = sampleExperiment(20000);
+    const std::vector<int> windows = {0, 2, 4, 6};
+    FeatureMatrixCache cache(directory.path());
+
+    // Every window requested by several threads at once
+    std::vector<std::shared_ptr<const FeatureMatrix>> results(4 * windows.size());
+    ThreadPool pool(8);
+    pool.parallelFor(results.size(), [&](size_t i) { results[i] = cache.get(experiment, windows[i % windows.size()]); });
+
+    CHECK(cache.misses() == windows.size());
+    CHECK(cache.hits() == results.size() - windows.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+        CHECK(results[i] == results[i % windows.size()]);
+        CHECK(sameMatrix(*results[i], buildFeatureMatrix(experiment.getSamples(), windows[i % windows.size()])));
+    }
+}
+
+TEST_CASE(persistedMatrixReloads) {
+    TempDirectory directory("feature_cache_reload");
+    const EcofunctionalExperiment experiment = sampleExperiment(200);
+    const FeatureMatrixKey key = FeatureMatrixKey::forExperiment(experiment);
+    CHECK(key.toString().find_first_of(" /") == std::string::npos);
+
+    FeatureMatrix built;
+    {
+        FeatureMatrixCache cache(directory.path());
+        built = *cache.get(experiment);
+        CHECK(cache.misses() == 1);
+    }
+    CHECK(std::filesystem::exists(directory.path() + "/" + key.toString() + ".features"));
+
+    FeatureMatrixCache reloaded(directory.path());
+    CHECK(sameMatrix(*reloaded.get(experiment), built));
+    CHECK(reloaded.hits() == 1 && reloaded.misses() == 0);
+}
+
+TEST_CASE(editedSamplesMissTheCache) {
+    TempDirectory directory("feature_cache_edited");
+    EcofunctionalExperiment experiment = sampleExperiment(100);
+    FeatureMatrixCache(directory.path()).get(experiment);
+
+    EcofunctionalExperiment edited = sampleExperiment(100);
+    edited.addSample(edited.getSamples()[0]);
+    FeatureMatrixCache cache(directory.path());
+    CHECK(sameMatrix(*cache.get(edited), buildFeatureMatrix(edited.getSamples())));
+    CHECK(cache.misses() == 1);
+}
+
+TEST_CASE(damagedFilesAreRebuilt) {
+    TempDirectory directory("feature_cache_damaged");
+    const EcofunctionalExperiment experiment = sampleExperiment(200);
+    const std::string path = directory.path() + "/" + FeatureMatrixKey::forExperiment(experiment).toString() + ".features";
+    const FeatureMatrix expected = buildFeatureMatrix(experiment.getSamples());
+    FeatureMatrixCache(directory.path()).get(experiment);
+    const std::string good = testing::readBytes(path);
+
+    std::string flippedPayload = good;
+    flippedPayload[good.size() - 3] ^= 0x40;
+    std::string otherPipeline = good;
+    otherPipeline[8] ^= 0x01; // pipelineVersion follows the 8-byte magic
+    std::string badMagic = good;
+    badMagic[0] = 'X';
+
+    const LogLevel previous = logLevel();
+    setLogLevel(LogLevel::ERROR); // expected "ignoring" warnings
+    for (const std::string& damaged :
+         {good.substr(0, 20), good.substr(0, good.size() - 1), flippedPayload, otherPipeline, badMagic}) {
+        testing::writeBytes(path, damaged);
+        FeatureMatrixCache cache(directory.path());
+        CHECK(sameMatrix(*cache.get(experiment), expected));
+        CHECK(cache.misses() == 1 && cache.hits() == 0);
+        CHECK(testing::readBytes(path) == good); // rewritten
+    }
+    setLogLevel(previous);
+}
+
+int main() {
+    return testing::runAllTests();
+}
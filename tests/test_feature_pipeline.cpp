@@ -0,0 +1,80 @@
+#include "domain.h"
+#include "feature_pipeline.h"
+#include "services.h"
+#include "test_harness.h"
+#include <cstring>
+
+// The streaming feature state (push/featureRow) and the column-wise matrix
+// build (buildColumn) must produce the same rows bit for bit, including the
+// rows where the windows are still filling
+
+namespace {
+
+features::Attributes attributesAt(size_t step) {
+    features::Attributes values;
+    for (size_t c = 0; c < ECOVECTOR_SIZE; ++c) {
+        // Mixed magnitudes so float rounding differs between summation orders
+        values[c] = static_cast<float>((step * 131 + c * 17) % 97) * 0.37f - 9.0f +
+                    1000.0f * static_cast<float>((step + c) % 5 == 0);
+    }
+    return values;
+}
+
+template <class Pipeline>
+bool streamingMatchesColumns(size_t n) {
+    std::array<std::vector<float>, ECOVECTOR_SIZE> columns;
+    for (size_t t = 0; t < n; ++t) {
+        const features::Attributes x = attributesAt(t);
+        for (size_t c = 0; c < ECOVECTOR_SIZE; ++c) columns[c].push_back(x[c]);
+    }
+    std::vector<typename Pipeline::Row> built(n);
+    for (size_t c = 0; c < ECOVECTOR_SIZE; ++c) {
+        Pipeline::buildColumn(columns[c].data(), n, c, 0, built.data());
+    }
+
+    typename Pipeline::State state;
+    typename Pipeline::Row row;
+    for (size_t t = 0; t < n; ++t) {
+        Pipeline::push(state, attributesAt(t), t);
+        Pipeline::write(state, row.data());
+        if (std::memcmp(row.data(), built[t].data(), sizeof(row)) != 0) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+TEST_CASE(featureStateMatchesFeatureMatrix) {
+    EcofunctionalSampleStore samples;
+    EcofunctionalFeatureState state;
+    std::vector<FeatureVector> streamed;
+    for (size_t t = 0; t < 5000; ++t) {
+        const EcofunctionalSample sample{EcofunctionalVector::fromArray(attributesAt(t)), 0.0f};
+        samples.push_back(sample);
+        state.push(sample.inputVector);
+        streamed.push_back(state.featureRow());
+    }
+
+    const std::vector<FeatureVector> built = buildFeatureMatrix(samples);
+    CHECK(built.size() == streamed.size());
+    for (size_t t = 0; t < built.size(); ++t) {
+        CHECK(std::memcmp(built[t].data(), streamed[t].data(), sizeof(FeatureVector)) == 0);
+    }
+
+    // The window-filling rows average what has been seen so far
+    CHECK(built[0][2 * ECOVECTOR_SIZE] == attributesAt(0)[0]);
+    CHECK(EcofunctionalFeatureState{}.featureRow() == FeatureVector{});
+}
+
+TEST_CASE(everyBlockStreamsLikeItsColumn) {
+    using Rich = features::FeaturePipeline<features::Current, features::Delta<1>, features::Delta<3>,
+                                           features::RollingMean<3>, features::RollingMean<8>,
+                                           features::RollingVariance<5>>;
+    CHECK(streamingMatchesColumns<ActiveFeaturePipeline>(2000));
+    CHECK(streamingMatchesColumns<Rich>(2000));
+    CHECK(Rich::HISTORY == 7 && Rich::lookback(0) == 7 && Rich::lookback(12) == 11);
+}
+
+int main() {
+    return testing::runAllTests();
+}
@@ -0,0 +1,121 @@
+#pragma once
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// ==========================================
+// Minimal test harness
+// ==========================================
+// Every tests/test_*.cpp is its own ctest executable: TEST_CASE registers a
+// function, CHECK* record failures without stopping the case, and main()
+// returns runAllTests(). An exception escaping a case fails it.
+
+namespace testing {
+
+struct TestCase {
+    const char* name;
+    void (*run)();
+};
+
+inline std::vector<TestCase>& registry() {
+    static std::vector<TestCase> cases;
+    return cases;
+}
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+inline bool registerTest(const char* name, void (*run)()) {
+    registry().push_back({name, run});
+    return true;
+}
+
+inline void fail(const char* file, int line, const std::string& message) {
+    std::fprintf(stderr, "%s:%d: %s\n", file, line, message.c_str());
+    failures()++;
+}
+
+// Bitwise float equality, except that any two NaNs match: the sign of a NaN
+// produced from two NaN operands depends on instruction operand order
+inline bool sameValue(float a, float b) {
+    if (std::isnan(a) || std::isnan(b)) return std::isnan(a) && std::isnan(b);
+    return std::memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+// Scratch file in the system temp directory, removed when the holder goes out of scope
+class TempFile {
+public:
+    explicit TempFile(const std::string& name)
+        : path_((std::filesystem::temp_directory_path() / ("ecoperceptron_test_" + name)).string()) {
+        std::filesystem::remove(path_);
+    }
+    ~TempFile() {
+        std::error_code ignored;
+        std::filesystem::remove(path_, ignored);
+    }
+    TempFile(const TempFile&) = delete;
+    TempFile& operator=(const TempFile&) = delete;
+
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+};
+
+inline std::string readBytes(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+inline void writeBytes(const std::string& path, const std::string& bytes) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+inline int runAllTests() {
+    int failedCases = 0;
+    for (const TestCase& test : registry()) {
+        const int before = failures();
+        try {
+            test.run();
+        } catch (const std::exception& e) {
+            fail(__FILE__, __LINE__, std::string("unexpected exception: ") + e.what());
+        }
+        const bool passed = failures() == before;
+        std::printf("[%s] %s\n", passed ? "PASS" : "FAIL", test.name);
+        if (!passed) failedCases++;
+    }
+    std::printf("%zu cases, %d failed\n", registry().size(), failedCases);
+    return failedCases == 0 ? 0 : 1;
+}
+
+} // namespace testing
+
+#define TEST_CASE(name)                                                                  \
+    static void name();                                                                  \
+    static const bool name##_registered = testing::registerTest(#name, name);            \
+    static void name()
+
+#define CHECK(condition)                                                                 \
+    do {                                                                                 \
+        if (!(condition)) testing::fail(__FILE__, __LINE__, "CHECK(" #condition ")");    \
+    } while (0)
+
+#define CHECK_THROWS(expression)                                                         \
+    do {                                                                                 \
+        bool threw_ = false;                                                             \
+        try {                                                                            \
+            (void)(expression);                                                          \
+        } catch (...) {                                                                  \
+            threw_ = true;                                                               \
+        }                                                                                \
+        if (!threw_) testing::fail(__FILE__, __LINE__, "no exception from " #expression); \
+    } while (0)
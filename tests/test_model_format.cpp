@@ -0,0 +1,152 @@
+#include "model_format.h"
+#include "perceptron.h"
+#include "test_harness.h"
+#include <cstring>
+#include <stdexcept>
+
+// .ecomodel and JSON model round trips, and rejection of damaged binary models
+
+namespace {
+
+Perceptron trainedModel() {
+    std::vector<FeatureVector> rows(64);
+    std::vector<float> labels(rows.size());
+    for (size_t r = 0; r < rows.size(); ++r) {
+        for (size_t c = 0; c < ECOFEATURE_VECTOR_SIZE; ++c) {
+            rows[r][c] = 0.1f * static_cast<float>((r * 3 + c * 5) % 17) - 0.8f;
+        }
+        labels[r] = (r % 4 == 0) ? 1.0f : 0.2f;
+    }
+    Perceptron model;
+    model.train(rows, labels, 0.05f, 5);
+    return model;
+}
+
+bool sameWeights(const Perceptron& a, const Perceptron& b) {
+    return std::memcmp(a.weights().data(), b.weights().data(), sizeof(FeatureVector)) == 0 &&
+           testing::sameValue(a.bias(), b.bias());
+}
+
+// Message of the runtime_error thrown while loading 'path', empty if it loads
+std::string loadError(const std::string& path) {
+    Perceptron model;
+    try {
+        model.load(path);
+    } catch (const std::runtime_error& error) {
+        return error.what();
+    }
+    return "";
+}
+
+bool startsWith(const std::string& text, const std::string& prefix) {
+    return text.compare(0, prefix.size(), prefix) == 0;
+}
+
+} // namespace
+
+TEST_CASE(binaryRoundTrip) {
+    const Perceptron model = trainedModel();
+    testing::TempFile file("roundtrip.ecomodel");
+    model.save(file.path());
+
+    const std::string bytes = testing::readBytes(file.path());
+    CHECK(bytes.size() == sizeof(ModelFileHeader) + sizeof(FeatureVector) + sizeof(float));
+    CHECK(std::memcmp(bytes.data(), MODEL_MAGIC, sizeof(MODEL_MAGIC)) == 0);
+
+    Perceptron loaded;
+    loaded.load(file.path());
+    CHECK(sameWeights(model, loaded));
+
+    ModelFile mapped;
+    mapped.open(file.path());
+    CHECK(mapped.inputSize() == ECOFEATURE_VECTOR_SIZE);
+    CHECK(mapped.pipelineVersion() == FEATURE_PIPELINE_VERSION);
+    CHECK(reinterpret_cast<uintptr_t>(mapped.weights()) % MODEL_ALIGNMENT == 0);
+}
+
+TEST_CASE(jsonIsTheDefaultFormat) {
+    const Perceptron model = trainedModel();
+    for (const std::string name : {"model.json", "model.bin", "model"}) {
+        testing::TempFile file(name);
+        model.save(file.path());
+        CHECK(testing::readBytes(file.path()).find("\"pipeline_version\"") != std::string::npos);
+
+        Perceptron loaded;
+        loaded.load(file.path());
+        CHECK(sameWeights(model, loaded));
+    }
+}
+
+TEST_CASE(jsonRejectsOtherPipelines) {
+    testing::TempFile file("other.json");
+    testing::writeBytes(file.path(), "{\"weights\": [1, 2, 3], \"bias\": 0}");
+    CHECK(startsWith(loadError(file.path()), "Model weight count"));
+
+    std::string weights;
+    for (size_t i = 0; i < ECOFEATURE_VECTOR_SIZE; ++i) weights += (i == 0 ? "0" : ", 0");
+    testing::writeBytes(file.path(), "{\"weights\": [" + weights + "], \"bias\": 0, \"pipeline_version\": " +
+                                         std::to_string(FEATURE_PIPELINE_VERSION + 1) + "}");
+    CHECK(startsWith(loadError(file.path()), "Model was trained with another feature pipeline"));
+
+    // Exports without a version predate pipeline changes and still load
+    testing::writeBytes(file.path(), "{\"weights\": [" + weights + "], \"bias\": 0.5}");
+    CHECK(loadError(file.path()).empty());
+}
+
+TEST_CASE(damagedBinaryModelsAreRejected) {
+    testing::TempFile file("damaged.ecomodel");
+    trainedModel().save(file.path());
+    const std::string good = testing::readBytes(file.path());
+
+    auto errorFor = [&](const std::string& bytes) {
+        testing::writeBytes(file.path(), bytes);
+        return loadError(file.path());
+    };
+    auto patched = [&](size_t offset, uint32_t value) {
+        std::string bytes = good;
+        std::memcpy(&bytes[offset], &value, sizeof(value));
+        return bytes;
+    };
+
+    CHECK(errorFor(good).empty());
+    CHECK(startsWith(errorFor(good.substr(0, sizeof(ModelFileHeader) - 1)), "Model file too small"));
+    std::string badMagic = good;
+    badMagic[0] = 'X';
+    CHECK(startsWith(errorFor(badMagic), "Not a model file"));
+    CHECK(startsWith(errorFor(patched(offsetof(ModelFileHeader, version), MODEL_FORMAT_VERSION + 1)),
+                     "Unsupported model format version"));
+    CHECK(startsWith(errorFor(patched(offsetof(ModelFileHeader, inputSize), ECOFEATURE_VECTOR_SIZE + 1)),
+                     "Model input size"));
+    CHECK(startsWith(errorFor(patched(offsetof(ModelFileHeader, pipelineVersion), FEATURE_PIPELINE_VERSION + 1)),
+                     "Model was trained with feature pipeline"));
+    CHECK(startsWith(errorFor(good.substr(0, good.size() - 1)), "Model payload out of bounds"));
+
+    std::string flippedWeight = good;
+    flippedWeight[sizeof(ModelFileHeader) + 5] ^= 0x01;
+    CHECK(startsWith(errorFor(flippedWeight), "Model checksum mismatch"));
+
+    testing::TempFile missing("missing.ecomodel");
+    CHECK(startsWith(loadError(missing.path()), "Cannot open model file"));
+}
+
+TEST_CASE(unopenedModelFileIsRejected) {
+    Perceptron model;
+    ModelFile unopened;
+    CHECK(!unopened.isOpen());
+    CHECK_THROWS(model.load(unopened));
+
+    // A failed open leaves the file closed, even after an earlier success
+    testing::TempFile file("reopen.ecomodel");
+    trainedModel().save(file.path());
+    ModelFile reopened;
+    reopened.open(file.path());
+    CHECK(reopened.isOpen());
+    testing::writeBytes(file.path(), "truncated");
+    CHECK_THROWS(reopened.open(file.path()));
+    CHECK(!reopened.isOpen());
+    CHECK_THROWS(model.load(reopened));
+}
+
+int main() {
+    return testing::runAllTests();
+}
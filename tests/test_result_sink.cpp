@@ -0,0 +1,90 @@
+#include "result_sink.h"
+#include "test_harness.h"
+#include <cstring>
+#include <stdexcept>
+
+// Exact bytes written by the NDJSON and .ecores result sinks
+
+namespace {
+
+template <typename T>
+void appendRaw(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+} // namespace
+
+TEST_CASE(ndjsonLines) {
+    testing::TempFile file("results.ndjson");
+    {
+        NdjsonResultSink sink(file.path(), 64); // small buffer: several flushes
+        const InferenceOutput outputs[2] = {{0.25f, 0.5f, 1.0f}, {0.1f, 0.75f, 0.0f}};
+        sink.write("", 0, outputs, 2);
+        sink.write("PLOT \"A\"\\\n", 4294967296ULL, outputs[1]);
+        sink.close();
+        CHECK(sink.rowsWritten() == 3);
+        CHECK_THROWS(sink.write("", 3, outputs[0]));
+    }
+    CHECK(testing::readBytes(file.path()) ==
+          "{\"step\":0,\"functional_integrity\":0.5,\"recovery_capacity\":1,\"resilience_potential\":0.25}\n"
+          "{\"step\":1,\"functional_integrity\":0.75,\"recovery_capacity\":0,\"resilience_potential\":0.1}\n"
+          "{\"plot_id\":\"PLOT \\\"A\\\"\\\\\\u000a\",\"step\":4294967296,\"functional_integrity\":0.75,"
+          "\"recovery_capacity\":0,\"resilience_potential\":0.1}\n");
+}
+
+TEST_CASE(binaryLayout) {
+    testing::TempFile file("results.ecores");
+    const InferenceOutput a{0.25f, 0.5f, 1.0f};
+    const InferenceOutput b{0.1f, 0.75f, 0.0f};
+    {
+        BinaryResultSink sink(file.path(), 2 * sizeof(ResultRecord));
+        sink.write("PLOT-B", 7, b);
+        sink.write("PLOT-A", 5000000000ULL, a);
+        sink.write("PLOT-B", 8, a);
+        sink.close();
+    }
+
+    std::string expected;
+    ResultFileHeader header{};
+    std::memcpy(header.magic, RESULT_FILE_MAGIC, sizeof(header.magic));
+    header.version = RESULT_FILE_VERSION;
+    header.recordSize = sizeof(ResultRecord);
+    header.recordCount = 3;
+    header.plotTableOffset = sizeof(ResultFileHeader) + 3 * sizeof(ResultRecord);
+    header.plotCount = 2;
+    appendRaw(expected, header);
+    appendRaw(expected, ResultRecord{7, 0, b.functionalIntegrity, b.recoveryCapacity, b.resiliencePotential});
+    appendRaw(expected, ResultRecord{5000000000ULL, 1, a.functionalIntegrity, a.recoveryCapacity, a.resiliencePotential});
+    appendRaw(expected, ResultRecord{8, 0, a.functionalIntegrity, a.recoveryCapacity, a.resiliencePotential});
+    for (const std::string id : {"PLOT-B", "PLOT-A"}) {
+        appendRaw(expected, static_cast<uint32_t>(id.size()));
+        expected += id;
+    }
+    CHECK(testing::readBytes(file.path()) == expected);
+}
+
+TEST_CASE(emptyBinaryFile) {
+    testing::TempFile file("empty.ecores");
+    BinaryResultSink(file.path()).close();
+    const std::string bytes = testing::readBytes(file.path());
+    CHECK(bytes.size() == sizeof(ResultFileHeader));
+
+    ResultFileHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    CHECK(header.recordCount == 0 && header.plotCount == 0);
+    CHECK(header.plotTableOffset == sizeof(ResultFileHeader));
+}
+
+TEST_CASE(sinkSelectedByExtension) {
+    testing::TempFile binary("chosen.ecores");
+    testing::TempFile text("chosen.json");
+    openResultSink(binary.path())->close();
+    openResultSink(text.path())->close();
+    CHECK(testing::readBytes(binary.path()).compare(0, 8, std::string(RESULT_FILE_MAGIC, 8)) == 0);
+    CHECK(testing::readBytes(text.path()).empty());
+    CHECK_THROWS(openResultSink("/nonexistent-directory/results.ndjson"));
+}
+
+int main() {
+    return testing::runAllTests();
+}
@@ -0,0 +1,100 @@
+#include "perceptron.h"
+#include "test_harness.h"
+#include <cstring>
+#include <stdexcept>
+
+// Training paths: SYNCHRONOUS data-parallel runs are reproducible, and a
+// single thread runs the plain per-sample SGD
+
+namespace {
+
+struct Dataset {
+    std::vector<FeatureVector> X;
+    std::vector<float> y;
+};
+
+Dataset sampleDataset(size_t rows) {
+    Dataset data{std::vector<FeatureVector>(rows), std::vector<float>(rows)};
+    for (size_t r = 0; r < rows; ++r) {
+        float sum = 0.0f;
+        for (size_t c = 0; c < ECOFEATURE_VECTOR_SIZE; ++c) {
+            data.X[r][c] = static_cast<float>((r * 29 + c * 13) % 41) / 41.0f - 0.5f;
+            sum += data.X[r][c] * ((c % 3 == 0) ? 1.0f : -0.5f);
+        }
+        data.y[r] = sum > 0.0f ? 0.9f : 0.1f;
+    }
+    return data;
+}
+
+bool sameModel(const Perceptron& a, const Perceptron& b) {
+    return std::memcmp(a.weights().data(), b.weights().data(), sizeof(FeatureVector)) == 0 &&
+           testing::sameValue(a.bias(), b.bias());
+}
+
+Perceptron trained(const Dataset& data, const TrainingOptions& options) {
+    Perceptron model;
+    model.train(data.X, data.y, options);
+    return model;
+}
+
+} // namespace
+
+TEST_CASE(synchronousTrainingIsDeterministic) {
+    const Dataset data = sampleDataset(1000); // last batch is partial
+    for (size_t threads : {size_t{2}, size_t{4}, size_t{7}}) {
+        TrainingOptions options;
+        options.learningRate = 0.2f;
+        options.epochs = 20;
+        options.batchSize = 64;
+        options.threads = threads;
+        options.parallelMode = ParallelMode::SYNCHRONOUS;
+
+        const Perceptron first = trained(data, options);
+        for (int run = 0; run < 5; ++run) {
+            CHECK(sameModel(first, trained(data, options)));
+        }
+        CHECK(!sameModel(first, Perceptron{})); // it did train
+    }
+}
+
+TEST_CASE(singleThreadRunsPlainSgd) {
+    const Dataset data = sampleDataset(300);
+    const float lr = 0.1f;
+    const int epochs = 15;
+
+    Perceptron reference;
+    for (int e = 0; e < epochs; ++e) {
+        for (size_t i = 0; i < data.X.size(); ++i) reference.update(data.X[i], data.y[i], lr);
+    }
+
+    TrainingOptions options;
+    options.learningRate = lr;
+    options.epochs = epochs;
+    for (ParallelMode mode : {ParallelMode::SYNCHRONOUS, ParallelMode::HOGWILD}) {
+        options.threads = 1;
+        options.parallelMode = mode;
+        CHECK(sameModel(reference, trained(data, options)));
+    }
+
+    Perceptron legacy;
+    legacy.train(data.X, data.y, lr, epochs);
+    CHECK(sameModel(reference, legacy));
+}
+
+TEST_CASE(parallelOptionsAreValidated) {
+    const Dataset data = sampleDataset(50);
+    TrainingOptions options;
+    options.epochs = 1;
+    options.threads = 2;
+    options.batchSize = 1;
+    Perceptron model;
+    CHECK_THROWS(model.train(data.X, data.y, options)); // synchronous needs mini-batches
+
+    options.parallelMode = ParallelMode::HOGWILD;
+    options.tolerance = 0.01f;
+    CHECK_THROWS(model.train(data.X, data.y, options)); // no early stopping in HOGWILD
+}
+
+int main() {
+    return testing::runAllTests();
+}
@@ -0,0 +1,26 @@
+// Converts a training, trajectory or fleet CSV into the binary columnar
+// format (.ecol) read by DataLoader::load*FromColumnar.
+#include <iostream>
+#include <string>
+#include "columnar_dataset.h"
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: csv_to_columnar <input.csv> <output.ecol>" << std::endl;
+        return 1;
+    }
+
+    try {
+        ColumnarTable table = columnarTableFromCSV(argv[1]);
+        writeColumnarFile(argv[2], table);
+        std::cout << "[Columnar] Wrote " << table.rowCount() << " rows"
+                  << (table.target.empty() ? "" : ", target")
+                  << (table.plotIndex.empty() ? "" : ", " + std::to_string(table.plotIds.size()) + " plots")
+                  << (table.timestamps.empty() ? "" : ", timestamps")
+                  << " to " << argv[2] << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "[Columnar] " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,164 @@
+// Writes a reproducible synthetic dataset (see synthetic_data.h) as CSV or
+// binary columnar (.ecol). One plot gives a training experiment / trajectory
+// file; several plots add a PlotId column and give a fleet file. Every row
+// carries the FunctionalIntegrity label, which the trajectory and fleet
+// loaders ignore.
+#include <array>
+#include <charconv>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "columnar_dataset.h"
+#include "synthetic_data.h"
+
+namespace {
+
+struct GeneratorOptions {
+    std::string outputPath;
+    size_t plots = 1;
+    size_t steps = 1000;
+    uint64_t seed = 1;
+};
+
+constexpr size_t CSV_BUFFER_BYTES = 1 << 20;
+constexpr int CSV_DECIMALS = 5;
+
+class RegimeCounter {
+public:
+    void add(EcosystemRegime regime) { counts_[static_cast<size_t>(regime)]++; total_++; }
+    void print() const {
+        std::cout << "[Generator] Regime mix:";
+        for (size_t r = 0; r < counts_.size(); ++r) {
+            std::printf(" %s %.1f%%", ecosystemRegimeName(static_cast<EcosystemRegime>(r)),
+                        total_ ? 100.0 * counts_[r] / total_ : 0.0);
+        }
+        std::printf("\n");
+    }
+private:
+    std::array<size_t, 4> counts_{};
+    size_t total_ = 0;
+};
+
+void appendValue(std::string& out, float value) {
+    char digits[32];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::fixed, CSV_DECIMALS);
+    out.append(digits, result.ptr);
+}
+
+// Streams rows through a fixed buffer; memory does not grow with the row count
+void writeCsv(const GeneratorOptions& options, RegimeCounter& regimes) {
+    std::ofstream out(options.outputPath, std::ios::binary);
+    if (!out.is_open()) {
+        throw std::runtime_error("Cannot create " + options.outputPath);
+    }
+    const bool withPlotId = options.plots > 1;
+
+    std::string buffer;
+    buffer.reserve(CSV_BUFFER_BYTES + 256);
+    if (withPlotId) buffer += "PlotId,";
+    buffer += "SoilDepth,SoilComp,SoilInfilt,HydroFlux,ErosionRisk,VegCovEI,VegCovES,"
+              "VegVigorEI,VegVigorES,PropPot,FunctionalIntegrity\n";
+
+    for (size_t p = 0; p < options.plots; ++p) {
+        SyntheticPlotGenerator generator(options.seed, p);
+        const std::string plotId = syntheticPlotId(p);
+        for (size_t s = 0; s < options.steps; ++s) {
+            const EcofunctionalSample sample = generator.next();
+            regimes.add(generator.regime());
+
+            if (withPlotId) {
+                buffer += plotId;
+                buffer += ',';
+            }
+            for (float value : sample.inputVector.toArray()) {
+                appendValue(buffer, value);
+                buffer += ',';
+            }
+            appendValue(buffer, sample.targetLabel);
+            buffer += '\n';
+
+            if (buffer.size() >= CSV_BUFFER_BYTES) {
+                out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                buffer.clear();
+            }
+        }
+    }
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    if (!out) {
+        throw std::runtime_error("Failed writing " + options.outputPath);
+    }
+}
+
+// Streams too: only one chunk of rows per column and the plot id table are held
+void writeColumnar(const GeneratorOptions& options, RegimeCounter& regimes) {
+    const bool withPlotId = options.plots > 1;
+    std::vector<std::string> plotIds;
+    if (withPlotId) {
+        for (size_t p = 0; p < options.plots; ++p) plotIds.push_back(syntheticPlotId(p));
+    }
+    ColumnarStreamWriter out(options.outputPath, options.plots * options.steps,
+                             COLUMNAR_HAS_TARGET | (withPlotId ? COLUMNAR_HAS_PLOT_ID : 0u), std::move(plotIds));
+
+    for (size_t p = 0; p < options.plots; ++p) {
+        SyntheticPlotGenerator generator(options.seed, p);
+        for (size_t s = 0; s < options.steps; ++s) {
+            const EcofunctionalSample sample = generator.next();
+            regimes.add(generator.regime());
+            out.append(sample.inputVector.toArray(), sample.targetLabel, static_cast<uint32_t>(p));
+        }
+    }
+    out.close();
+}
+
+GeneratorOptions parseArgs(int argc, char* argv[]) {
+    GeneratorOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--", 0) != 0) {
+            if (!options.outputPath.empty()) throw std::invalid_argument("Unexpected argument: " + arg);
+            options.outputPath = arg;
+            continue;
+        }
+        if (i + 1 >= argc) throw std::invalid_argument("Missing value for argument: " + arg);
+        if (arg == "--plots") options.plots = std::stoull(argv[++i]);
+        else if (arg == "--steps") options.steps = std::stoull(argv[++i]);
+        else if (arg == "--seed") options.seed = std::stoull(argv[++i]);
+        else throw std::invalid_argument("Unknown argument: " + arg);
+    }
+    if (options.outputPath.empty()) throw std::invalid_argument("Missing output file");
+    if (options.plots == 0 || options.steps == 0) throw std::invalid_argument("--plots and --steps must be positive");
+    return options;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    GeneratorOptions options;
+    try {
+        options = parseArgs(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\nUsage: generate_ecosystem_data <output.csv|output.ecol>"
+                  << " [--plots P] [--steps S] [--seed N]" << std::endl;
+        return 1;
+    }
+
+    try {
+        RegimeCounter regimes;
+        if (isColumnarPath(options.outputPath)) {
+            writeColumnar(options, regimes);
+        } else {
+            writeCsv(options, regimes);
+        }
+        std::cout << "[Generator] Wrote " << options.plots * options.steps << " rows ("
+                  << options.plots << " plots x " << options.steps << " steps, seed " << options.seed
+                  << ") to " << options.outputPath << std::endl;
+        regimes.print();
+    } catch (const std::exception& e) {
+        std::cerr << "[Generator] " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,90 @@
+// Long-running inference server: loads a saved Perceptron once and scores
+// per-plot sample updates as they arrive, over a Unix domain socket or, without
+// --socket, over stdin/stdout (one request line in, one NDJSON line out; see
+// inference_server.h for the protocol). Stops on SIGINT/SIGTERM or end of stdin.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "inference_server.h"
+#include "logging.h"
+#include "perceptron.h"
+
+namespace {
+
+struct DaemonOptions {
+    std::string modelPath;
+    std::string socketPath; // Empty: serve stdin/stdout
+    InferenceServerOptions server;
+    LogLevel logLevel = LogLevel::INFO;
+};
+
+std::atomic<bool> stopRequested{false};
+
+extern "C" void onStopSignal(int) {
+    stopRequested = true;
+}
+
+DaemonOptions parseArgs(int argc, char* argv[]) {
+    DaemonOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) throw std::invalid_argument("Missing value for argument: " + arg);
+        if (arg == "--model") options.modelPath = argv[++i];
+        else if (arg == "--socket") options.socketPath = argv[++i];
+        else if (arg == "--max-batch") options.server.maxBatch = std::stoull(argv[++i]);
+        else if (arg == "--batch-window-us") options.server.batchWindow = std::chrono::microseconds(std::stoll(argv[++i]));
+        else if (arg == "--log-level") options.logLevel = parseLogLevel(argv[++i]);
+        else throw std::invalid_argument("Unknown argument: " + arg);
+    }
+    if (options.modelPath.empty()) throw std::invalid_argument("Missing --model");
+    if (options.server.maxBatch == 0) {
+        throw std::invalid_argument("--max-batch must be positive");
+    }
+    return options;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    DaemonOptions options;
+    try {
+        options = parseArgs(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\nUsage: inference_daemon --model <model.ecomodel|model.json>"
+                  << " [--socket <path>] [--max-batch N] [--batch-window-us N]"
+                  << " [--log-level error|warn|info|debug]" << std::endl;
+        return 1;
+    }
+    // On stdin/stdout the protocol owns std::cout; informational logs would corrupt it
+    setLogLevel(options.socketPath.empty() ? std::min(options.logLevel, LogLevel::WARN) : options.logLevel);
+
+    try {
+        Perceptron model;
+        model.load(options.modelPath);
+        InferenceBatcher batcher(model, options.server);
+
+        if (options.socketPath.empty()) {
+            std::ios::sync_with_stdio(false);
+            serveStream(batcher, std::cin, std::cout);
+        } else {
+            std::signal(SIGINT, onStopSignal);
+            std::signal(SIGTERM, onStopSignal);
+            ECO_LOG_INFO("[Server] Model " << options.modelPath << " loaded");
+            serveUnixSocket(batcher, options.socketPath, stopRequested);
+        }
+
+        const InferenceServerStats stats = batcher.stats();
+        ECO_LOG_INFO("[Server] " << stats.requests << " requests in " << stats.batches << " batches (largest "
+                     << stats.largestBatch << "), " << stats.plots << " plots tracked");
+    } catch (const std::exception& e) {
+        ECO_LOG_ERROR("[Server] " << e.what());
+        flushLog();
+        return 1;
+    }
+    flushLog();
+    return 0;
+}
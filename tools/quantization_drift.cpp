@@ -0,0 +1,121 @@
+// Reports how far quantized (int8 / fp16) scores drift from float32 scores
+// on a dataset, how many rows change side of the decision threshold (by
+// default the one interpretScore classifies recovery at), and how fast each
+// path scores it.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "data_loader.h"
+#include "perceptron.h"
+#include "quantized.h"
+#include "services.h"
+
+namespace {
+
+// Rows per second of 'score', repeated until the measurement is long enough to trust
+template <typename Fn>
+double rowsPerSecond(size_t rows, Fn&& score) {
+    using Clock = std::chrono::steady_clock;
+    size_t passes = 0;
+    const auto start = Clock::now();
+    double elapsed = 0.0;
+    do {
+        score();
+        ++passes;
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (elapsed < 0.2);
+    return static_cast<double>(rows) * passes / elapsed;
+}
+
+std::vector<FeatureVector> loadFeatures(const std::string& path) {
+    auto trajectory = DataLoader::loadTrajectory(path);
+    if (trajectory.history.empty()) {
+        throw std::runtime_error("No samples in " + path);
+    }
+    return buildFeatureMatrix(trajectory.history);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string modelPath, dataPath, calibrationPath;
+    float threshold = PerceptronInferenceService::HIGH_INTEGRITY_THRESHOLD;
+    std::vector<QuantizationMode> modes = {QuantizationMode::INT8, QuantizationMode::FP16};
+    bool valid = true;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--calibration" && i + 1 < argc) {
+            calibrationPath = argv[++i];
+        } else if (arg == "--threshold" && i + 1 < argc) {
+            threshold = std::stof(argv[++i]);
+        } else if (arg == "--mode" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode == "int8") modes = {QuantizationMode::INT8};
+            else if (mode == "fp16") modes = {QuantizationMode::FP16};
+            else valid = valid && mode == "both";
+        } else if (modelPath.empty()) {
+            modelPath = arg;
+        } else if (dataPath.empty()) {
+            dataPath = arg;
+        } else {
+            valid = false;
+        }
+    }
+    if (!valid || modelPath.empty() || dataPath.empty()) {
+        std::cerr << "Usage: quantization_drift <model> <data.csv|data.ecol> [--mode int8|fp16|both]"
+                  << " [--calibration <data.csv|data.ecol>] [--threshold T (default "
+                  << PerceptronInferenceService::HIGH_INTEGRITY_THRESHOLD << ")]" << std::endl;
+        return 1;
+    }
+
+    try {
+        Perceptron model;
+        model.load(modelPath);
+
+        const std::vector<FeatureVector> X = loadFeatures(dataPath);
+        // Calibrating on the scored data itself is the best case; pass another file to measure generalization
+        const std::vector<FeatureVector> calibration = calibrationPath.empty() ? X : loadFeatures(calibrationPath);
+
+        const size_t n = X.size();
+        // The reference is what the pipeline scores with (Perceptron::infer); the
+        // rate is that of the fastest float32 path
+        std::vector<float> reference(n), floatScores(n);
+        model.inferBatchScalar(X.data(), n, reference.data());
+        const double floatRate = rowsPerSecond(n, [&] { model.inferBatch(X.data(), n, floatScores.data()); });
+
+        std::printf("[Quantization] %zu rows, float32 %.0f bytes/row, %.2f Mrows/s\n",
+                    n, static_cast<double>(sizeof(FeatureVector)), floatRate / 1e6);
+
+        std::vector<float> scores(n);
+        for (QuantizationMode mode : modes) {
+            auto quantized = QuantizedPerceptron::fromModel(model, mode, calibration.data(), calibration.size());
+            const QuantizedMatrix rows = quantized.quantize(X.data(), n);
+            quantized.scoreBatch(rows, scores.data());
+            const double rate = rowsPerSecond(n, [&] { quantized.scoreBatch(rows, scores.data()); });
+
+            double maxDrift = 0.0, sumDrift = 0.0, sumSquared = 0.0;
+            size_t flips = 0;
+            for (size_t i = 0; i < n; ++i) {
+                const double drift = std::fabs(static_cast<double>(scores[i]) - reference[i]);
+                maxDrift = std::max(maxDrift, drift);
+                sumDrift += drift;
+                sumSquared += drift * drift;
+                if ((scores[i] > threshold) != (reference[i] > threshold)) ++flips;
+            }
+
+            std::printf("[Quantization] %s: %.0f bytes/row, %.2f Mrows/s (%.2fx), "
+                        "drift max %.3g mean %.3g rms %.3g, %zu decision flips at %g\n",
+                        quantizationModeName(mode), static_cast<double>(rows.bytes()) / n, rate / 1e6,
+                        rate / floatRate, maxDrift, sumDrift / n, std::sqrt(sumSquared / n), flips,
+                        static_cast<double>(threshold));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[Quantization] " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}